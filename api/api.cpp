@@ -925,6 +925,29 @@ OIDN_API_NAMESPACE_BEGIN
     return 0;
   }
 
+  OIDN_API void oidnSetFilterString(OIDNFilter hFilter, const char* name, const char* value)
+  {
+    Filter* filter = reinterpret_cast<Filter*>(hFilter);
+    OIDN_TRY
+      checkHandle(hFilter);
+      OIDN_LOCK_DEVICE(filter);
+      checkString(name);
+      filter->setString(name, value ? value : "");
+    OIDN_CATCH_DEVICE(filter)
+  }
+
+  OIDN_API const char* oidnGetFilterString(OIDNFilter hFilter, const char* name)
+  {
+    Filter* filter = reinterpret_cast<Filter*>(hFilter);
+    OIDN_TRY
+      checkHandle(hFilter);
+      OIDN_LOCK_DEVICE(filter);
+      checkString(name);
+      return filter->getString(name);
+    OIDN_CATCH_DEVICE(filter)
+    return nullptr;
+  }
+
   OIDN_API void oidnSetFilterProgressMonitorFunction(OIDNFilter hFilter,
                                                      OIDNProgressMonitorFunction func, void* userPtr)
   {
@@ -37,7 +37,8 @@ void printUsage()
             << "                     [-s/--size width height]" << std::endl
             << "                     [-t/--type float|half]" << std::endl
             << "                     [-q/--quality default|h|high|b|balanced|f|fast]" << std::endl
-            << "                     [--threads n] [--affinity 0|1] [--maxmem MB] [--inplace]" << std::endl
+            << "                     [--threads n] [--affinity 0|1] [--numa 0|1]" << std::endl
+            << "                     [--maxmem MB] [--inplace]" << std::endl
             << "                     [--buffer host(copy)|device(copy)|managed(copy)]" << std::endl
             << "                     [-v/--verbose 0-3]" << std::endl
             << "                     [--ld|--list_devices] [-l/--list] [-h/--help]" << std::endl;
@@ -277,6 +278,7 @@ int main(int argc, char* argv[])
   std::string run = ".*";
   int numThreads = -1;
   int setAffinity = -1;
+  int numaSubdevices = -1;
   int verbose = -1;
 
   try
@@ -336,6 +338,8 @@ int main(int argc, char* argv[])
         numThreads = args.getNextValue<int>();
       else if (opt == "affinity")
         setAffinity = args.getNextValue<int>();
+      else if (opt == "numa")
+        numaSubdevices = args.getNextValue<int>();
       else if (opt == "maxmem" || opt == "maxMemoryMB")
         maxMemoryMB = args.getNextValue<int>();
       else if (opt == "inplace")
@@ -409,6 +413,8 @@ int main(int argc, char* argv[])
       device.set("numThreads", numThreads);
     if (setAffinity >= 0)
       device.set("setAffinity", bool(setAffinity));
+    if (numaSubdevices >= 0)
+      device.set("numaSubdevices", bool(numaSubdevices));
 
     device.commit();
 
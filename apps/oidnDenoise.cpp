@@ -31,6 +31,7 @@ void printUsage()
             << "                   [-r/--ref reference_output.pfm] [--maxerror e]" << std::endl
             << "                   [-t/--type float|half]" << std::endl
             << "                   [-q/--quality default|h|high|b|balanced|f|fast]" << std::endl
+            << "                   [-p/--precision default|int8|fp16]" << std::endl
             << "                   [-w/--weights weights.tza]" << std::endl
             << "                   [--threads n] [--affinity 0|1] [--maxmem MB] [--inplace]" << std::endl
             << "                   [--buffer host|device|managed]" << std::endl
@@ -56,21 +57,6 @@ bool progressCallback(void* userPtr, double n)
   return !isCancelled;
 }
 
-std::vector<char> loadFile(const std::string& filename)
-{
-  std::ifstream file(filename, std::ios::binary);
-  if (file.fail())
-    throw std::runtime_error("cannot open file: '" + filename + "'");
-  file.seekg(0, file.end);
-  const size_t size = file.tellg();
-  file.seekg(0, file.beg);
-  std::vector<char> buffer(size);
-  file.read(buffer.data(), size);
-  if (file.fail())
-    throw std::runtime_error("error reading from file: '" + filename + "'");
-  return buffer;
-}
-
 int main(int argc, char* argv[])
 {
   DeviceType deviceType = DeviceType::Default;
@@ -80,6 +66,7 @@ int main(int argc, char* argv[])
   std::string outputFilename, refFilename;
   std::string weightsFilename;
   Quality quality = Quality::Default;
+  Precision precision = Precision::Default;
   Storage bufferStorage = Storage::Undefined;
   bool hdr = false;
   bool srgb = false;
@@ -171,6 +158,18 @@ int main(int argc, char* argv[])
         else
           throw std::runtime_error("invalid filter quality mode");
       }
+      else if (opt == "p" || opt == "precision")
+      {
+        const auto val = toLower(args.getNextValue());
+        if (val == "default")
+          precision = Precision::Default;
+        else if (val == "int8")
+          precision = Precision::Int8;
+        else if (val == "fp16")
+          precision = Precision::FP16;
+        else
+          throw std::runtime_error("invalid filter precision mode");
+      }
       else if (opt == "w" || opt == "weights")
         weightsFilename = args.getNextValue();
       else if (opt == "n")
@@ -312,14 +311,6 @@ int main(int argc, char* argv[])
     if (inplace && numRuns > 1)
       inputCopy = input->clone();
 
-    // Load the filter weights if specified
-    std::vector<char> weights;
-    if (!weightsFilename.empty())
-    {
-      std::cout << "Loading filter weights" << std::endl;
-      weights = loadFile(weightsFilename);
-    }
-
     // Initialize the denoising filter
     std::cout << "Initializing filter" << std::endl;
     timer.reset();
@@ -357,11 +348,15 @@ int main(int argc, char* argv[])
     if (quality != Quality::Default)
       filter.set("quality", quality);
 
+    if (precision != Precision::Default)
+      filter.set("precision", precision);
+
     if (maxMemoryMB >= 0)
       filter.set("maxMemoryMB", maxMemoryMB);
 
-    if (!weights.empty())
-      filter.setData("weights", weights.data(), weights.size());
+    // The weights file is memory-mapped by the filter
+    if (!weightsFilename.empty())
+      filter.set("weightsFile", weightsFilename);
 
     const bool showProgress = verbose <= 1;
     if (showProgress)
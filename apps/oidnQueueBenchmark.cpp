@@ -0,0 +1,242 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "common/common.h"
+#include "common/timer.h"
+#include "common/mpsc_queue.h"
+#include "common/atomic_waitable.h"
+#include "utils/arg_parser.h"
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+OIDN_NAMESPACE_USING
+
+// Measures the overhead of submitting functions to a queue processed by a worker thread, like the
+// CPU engine does for each operation. Compares a queue protected by a mutex and condition variable
+// with the lock-free queue
+
+void printUsage()
+{
+  std::cout << "Intel(R) Open Image Denoise - Queue Benchmark" << std::endl;
+  std::cout << "usage: oidnQueueBenchmark [-n ops] [--batch ops_per_wait] [--producers n]" << std::endl
+            << "                          [-h/--help]" << std::endl;
+}
+
+// Queue with a mutex and condition variable, notifying all waiters on every push and pop
+class LockingQueue
+{
+public:
+  LockingQueue() : thread([this] { process(); }) {}
+
+  ~LockingQueue()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      shutdown = true;
+    }
+    cond.notify_all();
+    thread.join();
+  }
+
+  void submit(std::function<void()>&& f)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      queue.push(std::move(f));
+    }
+    cond.notify_all();
+  }
+
+  void wait()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [&] { return queue.empty(); });
+  }
+
+private:
+  void process()
+  {
+    for (; ;)
+    {
+      std::function<void()> f;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&] { return !queue.empty() || shutdown; });
+        if (queue.empty())
+          return;
+        f = std::move(queue.front());
+      }
+
+      f();
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.pop();
+      }
+      cond.notify_all();
+    }
+  }
+
+  std::queue<std::function<void()>> queue;
+  bool shutdown = false;
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::thread thread;
+};
+
+// Lock-free queue with atomic waiting
+class LockFreeQueue
+{
+public:
+  LockFreeQueue() : queue(1024), thread([this] { process(); }) {}
+
+  ~LockFreeQueue()
+  {
+    shutdown = true;
+    numPushed.add();
+    thread.join();
+  }
+
+  void submit(std::function<void()>&& f)
+  {
+    for (; ;)
+    {
+      const uint32_t completed = numCompleted.load();
+      if (queue.tryPush(std::move(f)))
+        break;
+      numCompleted.wait(completed);
+    }
+    numPushed.add();
+  }
+
+  void wait()
+  {
+    const uint32_t target = uint32_t(queue.getPushCount());
+    for (; ;)
+    {
+      const uint32_t completed = numCompleted.load();
+      if (int32_t(completed - target) >= 0)
+        break;
+      numCompleted.wait(completed);
+    }
+  }
+
+private:
+  void process()
+  {
+    std::function<void()> f;
+    for (; ;)
+    {
+      const uint32_t pushed = numPushed.load();
+      if (!queue.tryPop(f))
+      {
+        if (shutdown)
+          return;
+        numPushed.wait(pushed);
+        continue;
+      }
+
+      f();
+      numCompleted.add();
+    }
+  }
+
+  MPSCQueue<std::function<void()>> queue;
+  AtomicWaitable numPushed;
+  AtomicWaitable numCompleted;
+  std::atomic<bool> shutdown{false};
+  std::thread thread;
+};
+
+// Returns the average time per submitted function in nanoseconds
+template<typename Queue>
+double runBenchmark(int numOps, int batchSize, int numProducers)
+{
+  Queue queue;
+  std::atomic<int> counter(0);
+
+  auto produce = [&](int numProducerOps)
+  {
+    for (int i = 0; i < numProducerOps; i += batchSize)
+    {
+      const int n = std::min(batchSize, numProducerOps - i);
+      for (int j = 0; j < n; ++j)
+        queue.submit([&] { counter.fetch_add(1, std::memory_order_relaxed); });
+      queue.wait();
+    }
+  };
+
+  Timer timer;
+
+  std::vector<std::thread> producers;
+  for (int i = 0; i < numProducers; ++i)
+    producers.emplace_back(produce, numOps / numProducers);
+  for (auto& producer : producers)
+    producer.join();
+
+  const double time = timer.query();
+
+  if (counter != (numOps / numProducers) * numProducers)
+    throw std::logic_error("not all functions were executed");
+
+  return time * 1e9 / counter;
+}
+
+int main(int argc, char* argv[])
+{
+  int numOps = 1000000;
+  int batchSize = 40; // approximate number of operations per tile
+  int numProducers = 1;
+
+  try
+  {
+    ArgParser args(argc, argv);
+    while (args.hasNext())
+    {
+      std::string opt = args.getNextOpt();
+      if (opt == "n")
+        numOps = args.getNextValue<int>();
+      else if (opt == "batch")
+        batchSize = args.getNextValue<int>();
+      else if (opt == "producers")
+        numProducers = args.getNextValue<int>();
+      else if (opt == "h" || opt == "help")
+      {
+        printUsage();
+        return 1;
+      }
+      else
+        throw std::invalid_argument("invalid argument '" + opt + "'");
+    }
+
+    if (numOps < 1 || batchSize < 1 || numProducers < 1)
+      throw std::runtime_error("invalid benchmark parameters");
+
+    std::cout << "Ops: " << numOps << ", batch: " << batchSize << ", producers: " << numProducers
+              << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    // Warm up
+    runBenchmark<LockingQueue>(numOps / 10 + 1, batchSize, numProducers);
+    runBenchmark<LockFreeQueue>(numOps / 10 + 1, batchSize, numProducers);
+
+    const double lockingTime  = runBenchmark<LockingQueue>(numOps, batchSize, numProducers);
+    const double lockFreeTime = runBenchmark<LockFreeQueue>(numOps, batchSize, numProducers);
+
+    std::cout << "mutex     : " << lockingTime  << " ns/op" << std::endl;
+    std::cout << "lock-free : " << lockFreeTime << " ns/op" << std::endl;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
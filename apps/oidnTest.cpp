@@ -3,11 +3,15 @@
 
 #include "common/common.h"
 #include "common/timer.h"
+#include "common/mpsc_queue.h"
 #include "utils/image_buffer.h"
 #include "utils/random.h"
 #include <cassert>
 #include <cmath>
 #include <limits>
+#include <fstream>
+#include <cstdio>
+#include <thread>
 
 #define CATCH_CONFIG_RUNNER
 #define CATCH_CONFIG_FAST_COMPILE
@@ -318,6 +322,56 @@ TEST_CASE("buffer read/write", "[buffer_rw]")
 
 // -------------------------------------------------------------------------------------------------
 
+TEST_CASE("submission queue", "[queue]")
+{
+  const int numProducers = 4;
+  const int numValuesPerProducer = 100000;
+
+  // Small queue to make the producers wait for the consumer often
+  MPSCQueue<int> queue(16);
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < numProducers; ++p)
+  {
+    producers.emplace_back([&, p]()
+    {
+      for (int i = 0; i < numValuesPerProducer; ++i)
+      {
+        while (!queue.tryPush(p * numValuesPerProducer + i))
+          std::this_thread::yield();
+      }
+    });
+  }
+
+  // Each value must be popped exactly once, and the values of a producer in push order
+  std::vector<int> nextValues(numProducers, 0);
+  bool ordered = true;
+  for (int n = 0; n < numProducers * numValuesPerProducer; )
+  {
+    int value;
+    if (!queue.tryPop(value))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    const int p = value / numValuesPerProducer;
+    ordered = ordered && (value % numValuesPerProducer) == nextValues[p];
+    nextValues[p] = value % numValuesPerProducer + 1;
+    ++n;
+  }
+
+  for (auto& producer : producers)
+    producer.join();
+
+  REQUIRE(ordered);
+  int value;
+  REQUIRE(!queue.tryPop(value));
+  REQUIRE(queue.getPushCount() == size_t(numProducers) * numValuesPerProducer);
+}
+
+// -------------------------------------------------------------------------------------------------
+
 #if defined(OIDN_FILTER_RT)
 
 void setFilterImage(FilterRef& filter, const char* name, const std::shared_ptr<ImageBuffer>& image,
@@ -987,6 +1041,152 @@ TEST_CASE("image size", "[size]")
 
 // -------------------------------------------------------------------------------------------------
 
+TEST_CASE("plan cache", "[plan_cache]")
+{
+  DeviceRef device = makeAndCommitDevice();
+
+  FilterRef filter = device.newFilter("RT");
+  REQUIRE(bool(filter));
+
+  auto commitImages = [&](int W, int H)
+  {
+    auto color  = makeConstImage(device, W, H);
+    auto output = makeConstImage(device, W, H);
+    setFilterImage(filter, "color",  color);
+    setFilterImage(filter, "output", output);
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+  };
+
+  const int numHits   = device.get<int>("planCacheHits");
+  const int numMisses = device.get<int>("planCacheMisses");
+
+  // New configurations
+  commitImages(257, 89);
+  commitImages(89, 257);
+  REQUIRE(device.get<int>("planCacheHits") == numHits);
+  REQUIRE(device.get<int>("planCacheMisses") == numMisses + 2);
+
+  // Previously seen configuration
+  commitImages(257, 89);
+  REQUIRE(device.get<int>("planCacheHits") == numHits + 1);
+  REQUIRE(device.get<int>("planCacheMisses") == numMisses + 2);
+
+  // Changing a parameter affecting the plan
+  filter.set("maxMemoryMB", 500);
+  commitImages(257, 89);
+  REQUIRE(device.get<int>("planCacheHits") == numHits + 1);
+  REQUIRE(device.get<int>("planCacheMisses") == numMisses + 3);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("weights cache", "[weights_cache]")
+{
+  DeviceRef device = makeAndCommitDevice();
+
+  const int W = 257;
+  const int H = 89;
+  auto color  = makeConstImage(device, W, H);
+  auto output = makeConstImage(device, W, H);
+
+  auto makeFilter = [&](bool hdr)
+  {
+    FilterRef filter = device.newFilter("RT");
+    REQUIRE(bool(filter));
+    setFilterImage(filter, "color",  color);
+    setFilterImage(filter, "output", output);
+    filter.set("hdr", hdr);
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    return filter;
+  };
+
+  FilterRef filter1 = makeFilter(false);
+  const int numHits   = device.get<int>("weightsCacheHits");
+  const int numMisses = device.get<int>("weightsCacheMisses");
+
+  // Filters with the same weights share the cached tensors
+  FilterRef filter2 = makeFilter(false);
+  REQUIRE(device.get<int>("weightsCacheHits") > numHits);
+  REQUIRE(device.get<int>("weightsCacheMisses") == numMisses);
+
+  filter2.execute();
+  REQUIRE(device.getError() == Error::None);
+
+  // Filters with different weights do not
+  FilterRef filter3 = makeFilter(true);
+  REQUIRE(device.get<int>("weightsCacheMisses") > numMisses);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("filter streams", "[filter_streams]")
+{
+  const int W = 257;
+  const int H = 89;
+  const int numStreams = 2;
+
+  DeviceRef device = makeDevice();
+  if (device.get<DeviceType>("type") != DeviceType::CPU)
+    return; // streams are supported only by the CPU device
+
+  device.set("numStreams", numStreams);
+  device.commit();
+  REQUIRE(device.getError() == Error::None);
+  REQUIRE(device.get<int>("numStreams") == numStreams);
+
+  auto color = makeRandomImage(device, W, H);
+  auto refOutput = makeImage(device, W, H);
+
+  FilterRef refFilter = device.newFilter("RT");
+  REQUIRE(bool(refFilter));
+  setFilterImage(refFilter, "color",  color);
+  setFilterImage(refFilter, "output", refOutput);
+  refFilter.commit();
+  refFilter.execute();
+  REQUIRE(device.getError() == Error::None);
+
+  SECTION("invalid stream")
+  {
+    refFilter.set("stream", numStreams);
+    refFilter.commit();
+    REQUIRE(device.getError() == Error::InvalidArgument);
+  }
+
+  SECTION("concurrent execution")
+  {
+    std::vector<FilterRef> filters;
+    std::vector<std::shared_ptr<ImageBuffer>> outputs;
+    for (int i = 0; i < numStreams; ++i)
+    {
+      outputs.push_back(makeImage(device, W, H));
+      filters.push_back(device.newFilter("RT"));
+      REQUIRE(bool(filters[i]));
+      setFilterImage(filters[i], "color",  color);
+      setFilterImage(filters[i], "output", outputs[i]);
+      filters[i].set("stream", i);
+      filters[i].commit();
+      REQUIRE(device.getError() == Error::None);
+    }
+
+    // Execute the filters from separate threads
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numStreams; ++i)
+      threads.emplace_back([&, i]() { filters[i].execute(); });
+    for (auto& thread : threads)
+      thread.join();
+    REQUIRE(device.getError() == Error::None);
+
+    for (int i = 0; i < numStreams; ++i)
+      REQUIRE(compareImage(*outputs[i], *refOutput));
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
 void sanitizationTest(DeviceRef& device, bool hdr, float value)
 {
   const int W = 191;
@@ -1214,6 +1414,778 @@ TEST_CASE("user weights", "[user_weights]")
     filter.commit();
     REQUIRE(device.getError() == Error::InvalidOperation);
   }
+
+  SECTION("missing file")
+  {
+    filter.set("weightsFile", "oidnTest_missing.tza");
+    REQUIRE(device.getError() == Error::InvalidArgument);
+    REQUIRE(filter.get<std::string>("weightsFile").empty());
+
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+  }
+
+  SECTION("invalid file")
+  {
+    const std::string filename = "oidnTest_weights.tza";
+    {
+      std::ofstream file(filename, std::ios::binary);
+      file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+
+    filter.set("weightsFile", filename);
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(filter.get<std::string>("weightsFile") == filename);
+
+    filter.commit();
+    REQUIRE(device.getError() == Error::InvalidOperation);
+
+    filter.set("weightsFile", "");
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(filter.get<std::string>("weightsFile").empty());
+    std::remove(filename.c_str());
+
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("batch filter", "[batch_filter]")
+{
+  const int W = 67;
+  const int H = 45;
+  const int batchSize = 3;
+
+  DeviceRef device = makeAndCommitDevice();
+
+  auto color  = makeRandomImage(device, W, H * batchSize, 3, DataType::Float32, 0.f, 10.f);
+  auto output = makeImage(device, W, H * batchSize);
+
+  FilterRef filter = device.newFilter("RT");
+  REQUIRE(bool(filter));
+
+  setFilterImage(filter, "color",  color);
+  setFilterImage(filter, "output", output);
+  filter.set("hdr", true);
+
+  SECTION("invalid batch size")
+  {
+    filter.set("batchSize", 0);
+    REQUIRE(device.getError() == Error::InvalidArgument);
+
+    filter.set("batchSize", 2); // image height is not a multiple of the batch size
+    filter.commit();
+    REQUIRE(device.getError() == Error::InvalidOperation);
+  }
+
+  SECTION("batch vs single images")
+  {
+    filter.set("batchSize", batchSize);
+    REQUIRE(filter.get<int>("batchSize") == batchSize);
+
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+
+    // Denoise the images one by one
+    auto refOutput = makeImage(device, W, H * batchSize);
+    const size_t imageByteSize = color->getByteSize() / batchSize;
+
+    FilterRef refFilter = device.newFilter("RT");
+    REQUIRE(bool(refFilter));
+    refFilter.set("hdr", true);
+
+    for (int b = 0; b < batchSize; ++b)
+    {
+      refFilter.setImage("color",  color->getBuffer(), color->getFormat(), W, H,
+                         b * imageByteSize);
+      refFilter.setImage("output", refOutput->getBuffer(), refOutput->getFormat(), W, H,
+                         b * imageByteSize);
+      refFilter.commit();
+      refFilter.execute();
+      REQUIRE(device.getError() == Error::None);
+    }
+
+    size_t numErrors;
+    double avgError;
+    std::tie(numErrors, avgError) = compareImage(*output, *refOutput, 1e-4);
+    REQUIRE(numErrors == 0);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("filter autotune", "[filter_autotune]")
+{
+  const int W = 1600; // wide enough for dividing into multiple tiles
+  const int H = 400;
+
+  DeviceRef device = makeAndCommitDevice();
+
+  auto color = makeRandomImage(device, W, H);
+  auto refOutput = makeImage(device, W, H);
+
+  FilterRef refFilter = device.newFilter("RT");
+  REQUIRE(bool(refFilter));
+  setFilterImage(refFilter, "color",  color);
+  setFilterImage(refFilter, "output", refOutput);
+  refFilter.commit();
+  refFilter.execute();
+  REQUIRE(device.getError() == Error::None);
+
+  // The second filter hits the tuning cache, so it must select the same tile plan
+  std::vector<std::shared_ptr<ImageBuffer>> outputs;
+  for (int i = 0; i < 2; ++i)
+  {
+    outputs.push_back(makeImage(device, W, H));
+    FilterRef filter = device.newFilter("RT");
+    REQUIRE(bool(filter));
+    setFilterImage(filter, "color",  color);
+    setFilterImage(filter, "output", outputs[i]);
+    filter.set("autotune", true);
+    filter.commit();
+    REQUIRE(filter.get<bool>("autotune"));
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+  }
+
+  REQUIRE(compareImage(*outputs[1], *outputs[0]));
+
+  // The tile size may differ from the default, which causes only small differences
+  size_t numErrors;
+  double avgError;
+  std::tie(numErrors, avgError) = compareImage(*outputs[0], *refOutput, 0.003);
+  REQUIRE(numErrors == 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("filter skip constant tiles", "[filter_skip_tiles]")
+{
+  const int W = 257;
+  const int H = 89;
+
+  DeviceRef device = makeAndCommitDevice();
+
+  // Computing the tile variances is supported only on CPU devices
+  const bool supported = device.get<DeviceType>("type") == DeviceType::CPU;
+
+  FilterRef filter = device.newFilter("RT");
+  REQUIRE(bool(filter));
+  filter.set("hdr", true);
+  filter.set("skipConstantTiles", true);
+  filter.set("constantTileThreshold", 1e-6f);
+  REQUIRE(filter.get<bool>("skipConstantTiles"));
+  REQUIRE(filter.get<float>("constantTileThreshold") == 1e-6f);
+
+  SECTION("invalid threshold")
+  {
+    filter.set("constantTileThreshold", -1.f);
+    REQUIRE(device.getError() == Error::InvalidArgument);
+    REQUIRE(filter.get<float>("constantTileThreshold") == 1e-6f);
+  }
+
+  SECTION("constant image")
+  {
+    // All tiles are passed through
+    auto color  = makeConstImage(device, W, H, 3, DataType::Float32, 2.f);
+    auto output = makeImage(device, W, H);
+    setFilterImage(filter, "color",  color);
+    setFilterImage(filter, "output", output);
+    filter.commit();
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+
+    if (supported)
+    {
+      REQUIRE(filter.get<int>("skippedTileCount") > 0);
+      REQUIRE(compareImage(*output, *color));
+    }
+  }
+
+  SECTION("out-of-range constant image")
+  {
+    // The passed through tiles must be clamped like the denoised ones
+    auto output = makeImage(device, W, H);
+    setFilterImage(filter, "output", output);
+
+    // Negative values in HDR mode are clamped to 0
+    auto color = makeConstImage(device, W, H, 3, DataType::Float32, -2.f);
+    auto refOutput = makeConstImage(device, W, H, 3, DataType::Float32, 0.f);
+    setFilterImage(filter, "color", color);
+    filter.commit();
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+
+    if (supported)
+    {
+      REQUIRE(filter.get<int>("skippedTileCount") > 0);
+      REQUIRE(compareImage(*output, *refOutput));
+    }
+
+    // Values greater than 1 in LDR mode are clamped to 1
+    color = makeConstImage(device, W, H, 3, DataType::Float32, 2.f);
+    refOutput = makeConstImage(device, W, H, 3, DataType::Float32, 1.f);
+    setFilterImage(filter, "color", color);
+    filter.set("hdr", false);
+    filter.commit();
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+
+    if (supported)
+    {
+      REQUIRE(filter.get<int>("skippedTileCount") > 0);
+      REQUIRE(compareImage(*output, *refOutput));
+    }
+  }
+
+  SECTION("noisy image")
+  {
+    // No tiles are passed through, so the output must match the output without skipping
+    auto color     = makeRandomImage(device, W, H, 3, DataType::Float32, 0.f, 10.f);
+    auto output    = makeImage(device, W, H);
+    auto refOutput = makeImage(device, W, H);
+
+    FilterRef refFilter = device.newFilter("RT");
+    REQUIRE(bool(refFilter));
+    setFilterImage(refFilter, "color",  color);
+    setFilterImage(refFilter, "output", refOutput);
+    refFilter.set("hdr", true);
+    refFilter.commit();
+    refFilter.execute();
+    REQUIRE(device.getError() == Error::None);
+
+    setFilterImage(filter, "color",  color);
+    setFilterImage(filter, "output", output);
+    filter.commit();
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+
+    REQUIRE(filter.get<int>("skippedTileCount") == 0);
+    REQUIRE(compareImage(*output, *refOutput));
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("filter precision", "[precision]")
+{
+  const int W = 67;
+  const int H = 45;
+
+  DeviceRef device = makeAndCommitDevice();
+
+  auto color     = makeRandomImage(device, W, H, 3, DataType::Float32, 0.f, 10.f);
+  auto output    = makeImage(device, W, H);
+  auto refOutput = makeImage(device, W, H);
+
+  // Reference output with the default precision
+  FilterRef refFilter = device.newFilter("RT");
+  REQUIRE(bool(refFilter));
+  setFilterImage(refFilter, "color",  color);
+  setFilterImage(refFilter, "output", refOutput);
+  refFilter.set("hdr", true);
+  refFilter.commit();
+  refFilter.execute();
+  REQUIRE(device.getError() == Error::None);
+
+  FilterRef filter = device.newFilter("RT");
+  REQUIRE(bool(filter));
+
+  setFilterImage(filter, "color",  color);
+  setFilterImage(filter, "output", output);
+  filter.set("hdr", true);
+
+  REQUIRE(filter.get<Precision>("precision") == Precision::Default);
+
+  SECTION("invalid precision")
+  {
+    filter.set("precision", 100);
+    REQUIRE(device.getError() == Error::InvalidArgument);
+    REQUIRE(filter.get<Precision>("precision") == Precision::Default);
+  }
+
+  SECTION("int8 fallback without calibrated weights")
+  {
+    // The built-in weights are not calibrated, so the default precision must be used
+    filter.set("precision", Precision::Int8);
+    REQUIRE(filter.get<Precision>("precision") == Precision::Int8);
+
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+
+    size_t numErrors;
+    double avgError;
+    std::tie(numErrors, avgError) = compareImage(*output, *refOutput, 1e-4);
+    REQUIRE(numErrors == 0);
+  }
+
+  SECTION("fp16")
+  {
+    // Half-precision activations (or the default precision if not supported by the device)
+    filter.set("precision", Precision::FP16);
+    REQUIRE(filter.get<Precision>("precision") == Precision::FP16);
+
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+
+    size_t numErrors;
+    double avgError;
+    std::tie(numErrors, avgError) = compareImage(*output, *refOutput, 0.005);
+    REQUIRE(numErrors == 0);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+using ParamList = std::vector<std::pair<const char*, int>>;
+
+// Denoises a random HDR image on a new CPU device with the specified device and filter parameters,
+// which select the execution path, and returns the output. The optional paths are implemented only
+// by the CPU device, so null is returned if the device is not a CPU
+std::shared_ptr<ImageBuffer> denoiseOnCPU(int W, int H,
+                                          const ParamList& deviceParams,
+                                          const ParamList& filterParams)
+{
+  DeviceRef device = makeDevice();
+  if (device.get<DeviceType>("type") != DeviceType::CPU)
+    return nullptr;
+
+  for (const auto& param : deviceParams)
+    device.set(param.first, param.second);
+  device.commit();
+  REQUIRE(device.getError() == Error::None);
+
+  auto color  = makeRandomImage(device, W, H, 3, DataType::Float32, 0.f, 10.f);
+  auto output = makeImage(device, W, H);
+
+  FilterRef filter = device.newFilter("RT");
+  REQUIRE(bool(filter));
+  setFilterImage(filter, "color",  color);
+  setFilterImage(filter, "output", output);
+  filter.set("hdr", true);
+  for (const auto& param : filterParams)
+    filter.set(param.first, param.second);
+  filter.commit();
+  REQUIRE(device.getError() == Error::None);
+
+  filter.execute();
+  REQUIRE(device.getError() == Error::None);
+  return output;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("pipelined tiles", "[pipelining]")
+{
+  const int W = 1031;
+  const int H = 323;
+  const ParamList filterParams = {{"maxMemoryMB", 20}}; // denoise in multiple tiles
+
+  // The input and output processing of the tiles may run concurrently with other tiles
+  auto output = denoiseOnCPU(W, H, {}, filterParams);
+  if (!output)
+    return;
+  auto refOutput = denoiseOnCPU(W, H, {{"concurrency", 0}}, filterParams);
+
+  size_t numErrors;
+  double avgError;
+  std::tie(numErrors, avgError) = compareImage(*output, *refOutput, 1e-4);
+  REQUIRE(numErrors == 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("depth-first execution", "[depth_first]")
+{
+  const int W = 1031; // wide enough for executing the op chains in multiple bands
+  const int H = 77;
+  const int batchSize = 2;
+
+  // Bands are smaller with fewer threads
+  const ParamList deviceParams    = {{"numThreads", 1}};
+  const ParamList refDeviceParams = {{"numThreads", 1}, {"depthFirst", 0}};
+
+  SECTION("high quality")
+  {
+    const ParamList filterParams = {{"quality", int(Quality::High)}};
+    auto output = denoiseOnCPU(W, H, deviceParams, filterParams);
+    if (!output)
+      return;
+    auto refOutput = denoiseOnCPU(W, H, refDeviceParams, filterParams);
+
+    size_t numErrors;
+    double avgError;
+    std::tie(numErrors, avgError) = compareImage(*output, *refOutput, 1e-4);
+    REQUIRE(numErrors == 0);
+  }
+
+  SECTION("fast math")
+  {
+    // The bands must not read rows which have not been computed yet (e.g. by Winograd tiles),
+    // also in the images of a batch
+    const ParamList filterParams = {{"quality", int(Quality::Balanced)}, {"batchSize", batchSize}};
+    auto output = denoiseOnCPU(W, H * batchSize, deviceParams, filterParams);
+    if (!output)
+      return;
+    auto refOutput = denoiseOnCPU(W, H * batchSize, refDeviceParams, filterParams);
+
+    size_t numErrors;
+    double avgError;
+    std::tie(numErrors, avgError) = compareImage(*output, *refOutput, 1e-4);
+    REQUIRE(numErrors == 0);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("Winograd convolution", "[winograd]")
+{
+  const int W = 257;
+  const int H = 89;
+
+  // The fast math convolutions use the Winograd algorithm instead of direct convolution (if AMX
+  // is not used instead), which is slightly less accurate
+  auto output = denoiseOnCPU(W, H, {{"amx", 0}}, {{"quality", int(Quality::Balanced)}});
+  if (!output)
+    return;
+  auto refOutput = denoiseOnCPU(W, H, {{"amx", 0}, {"winograd", 0}},
+                                {{"quality", int(Quality::Balanced)}});
+
+  size_t numErrors;
+  double avgError;
+  std::tie(numErrors, avgError) = compareImage(*output, *refOutput, 0.003);
+  REQUIRE(numErrors == 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("tile distribution", "[tile_distribution]")
+{
+  const int W = 1031;
+  const int H = 323;
+  const int maxMemoryMB = 20; // denoise in multiple tiles
+
+  DeviceRef device = makeAndCommitDevice();
+
+  auto color     = makeRandomImage(device, W, H, 3, DataType::Float32, 0.f, 10.f);
+  auto output    = makeImage(device, W, H);
+  auto refOutput = makeImage(device, W, H);
+
+  auto makeFilter = [&](const std::shared_ptr<ImageBuffer>& filterOutput)
+  {
+    FilterRef filter = device.newFilter("RT");
+    REQUIRE(bool(filter));
+    setFilterImage(filter, "color",  color);
+    setFilterImage(filter, "output", filterOutput);
+    filter.set("hdr", true);
+    filter.set("maxMemoryMB", maxMemoryMB);
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    return filter;
+  };
+
+  // With multiple subdevices, synchronous execution distributes the tiles dynamically, while
+  // asynchronous execution assigns them round-robin
+  FilterRef filter = makeFilter(output);
+  filter.execute();
+  REQUIRE(device.getError() == Error::None);
+
+  FilterRef refFilter = makeFilter(refOutput);
+  refFilter.executeAsync();
+  device.sync();
+  REQUIRE(device.getError() == Error::None);
+
+  REQUIRE(compareImage(*output, *refOutput));
+
+  SECTION("NUMA subdevices")
+  {
+    // A CPU device has a subdevice for each NUMA node if enabled
+    auto numaOutput = denoiseOnCPU(W, H, {{"numaSubdevices", 1}}, {{"maxMemoryMB", maxMemoryMB}});
+    if (!numaOutput)
+      return;
+    auto cpuOutput = denoiseOnCPU(W, H, {}, {{"maxMemoryMB", maxMemoryMB}});
+
+    size_t numErrors;
+    double avgError;
+    std::tie(numErrors, avgError) = compareImage(*numaOutput, *cpuOutput, 1e-4);
+    REQUIRE(numErrors == 0);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("concurrent submission", "[concurrent_submission]")
+{
+  const int W = 257;
+  const int H = 89;
+  const int numThreads = 4;
+  const int numIterations = 8;
+
+  DeviceRef device = makeAndCommitDevice();
+
+  auto color = makeRandomImage(device, W, H);
+  auto refOutput = makeImage(device, W, H);
+
+  FilterRef refFilter = device.newFilter("RT");
+  REQUIRE(bool(refFilter));
+  setFilterImage(refFilter, "color",  color);
+  setFilterImage(refFilter, "output", refOutput);
+  refFilter.commit();
+  refFilter.execute();
+  REQUIRE(device.getError() == Error::None);
+
+  std::vector<FilterRef> filters;
+  std::vector<std::shared_ptr<ImageBuffer>> outputs;
+  for (int i = 0; i < numThreads; ++i)
+  {
+    outputs.push_back(makeImage(device, W, H));
+    filters.push_back(device.newFilter("RT"));
+    REQUIRE(bool(filters[i]));
+    setFilterImage(filters[i], "color",  color);
+    setFilterImage(filters[i], "output", outputs[i]);
+    filters[i].commit();
+    REQUIRE(device.getError() == Error::None);
+  }
+
+  // Submit to the same queue from multiple threads, while other threads are waiting for it
+  std::vector<std::thread> threads;
+  for (int i = 0; i < numThreads; ++i)
+  {
+    threads.emplace_back([&, i]()
+    {
+      for (int j = 0; j < numIterations; ++j)
+      {
+        filters[i].executeAsync();
+        if ((i + j) % 2 == 0)
+          device.sync();
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  device.sync();
+  REQUIRE(device.getError() == Error::None);
+
+  for (int i = 0; i < numThreads; ++i)
+    REQUIRE(compareImage(*outputs[i], *refOutput));
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("dependency graph", "[dependency_graph]")
+{
+  const int W = 257;
+  const int H = 89;
+
+  SECTION("tracked vs serialized")
+  {
+    // Independent ops (e.g. the processing of pipelined tiles) run concurrently with tracking
+    const int tiledW = 1031;
+    const int tiledH = 323;
+    const ParamList filterParams = {{"maxMemoryMB", 20}}; // denoise in multiple tiles
+    auto output = denoiseOnCPU(tiledW, tiledH, {}, filterParams);
+    if (!output)
+      return;
+    auto refOutput = denoiseOnCPU(tiledW, tiledH, {{"dependencyTracking", 0}}, filterParams);
+
+    size_t numErrors;
+    double avgError;
+    std::tie(numErrors, avgError) = compareImage(*output, *refOutput, 1e-4);
+    REQUIRE(numErrors == 0);
+  }
+
+  SECTION("dependent filters")
+  {
+    const int numThreads = 4;
+    const int numIterations = 4;
+
+    DeviceRef device = makeAndCommitDevice();
+
+    auto color = makeRandomImage(device, W, H);
+
+    // Each thread denoises the output of its first filter again with a second filter, without
+    // waiting in between, so the second filter must wait for the first one
+    std::vector<std::array<FilterRef, 2>> filters(numThreads);
+    std::vector<std::array<std::shared_ptr<ImageBuffer>, 2>> outputs(numThreads);
+    for (int i = 0; i < numThreads; ++i)
+    {
+      for (int k = 0; k < 2; ++k)
+      {
+        outputs[i][k] = makeImage(device, W, H);
+        filters[i][k] = device.newFilter("RT");
+        REQUIRE(bool(filters[i][k]));
+        setFilterImage(filters[i][k], "color",  k == 0 ? color : outputs[i][0]);
+        setFilterImage(filters[i][k], "output", outputs[i][k]);
+        filters[i][k].commit();
+        REQUIRE(device.getError() == Error::None);
+      }
+    }
+
+    // Reference outputs executed one after the other
+    filters[0][0].execute();
+    filters[0][1].execute();
+    REQUIRE(device.getError() == Error::None);
+    auto refOutput = makeImage(device, W, H);
+    for (size_t j = 0; j < refOutput->getSize(); ++j)
+      refOutput->set(j, outputs[0][1]->get(j));
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; ++i)
+    {
+      threads.emplace_back([&, i]()
+      {
+        for (int j = 0; j < numIterations; ++j)
+        {
+          filters[i][0].executeAsync();
+          filters[i][1].executeAsync();
+        }
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+
+    device.sync();
+    REQUIRE(device.getError() == Error::None);
+
+    for (int i = 0; i < numThreads; ++i)
+      REQUIRE(compareImage(*outputs[i][1], *refOutput));
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("cache blocking", "[cache_blocking]")
+{
+  const int W = 257;
+  const int H = 89;
+
+  // Small caches change the blocking of the convolutions (e.g. the input channels are accumulated
+  // in more passes), which changes only the rounding
+  const ParamList filterParams = {{"quality", int(Quality::High)}};
+  auto output = denoiseOnCPU(W, H, {{"l1CacheSize", 4 * 1024}, {"l2CacheSize", 64 * 1024}},
+                             filterParams);
+  if (!output)
+    return;
+  auto refOutput = denoiseOnCPU(W, H, {}, filterParams);
+
+  size_t numErrors;
+  double avgError;
+  std::tie(numErrors, avgError) = compareImage(*output, *refOutput, 1e-4);
+  REQUIRE(numErrors == 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("2D convolution blocking", "[conv_2d_blocking]")
+{
+  const int W = 257;
+  const int H = 89;
+
+  // The convolutions with only a few output channel blocks compute two output rows at once
+  const ParamList filterParams = {{"quality", int(Quality::High)}};
+  auto output = denoiseOnCPU(W, H, {}, filterParams);
+  if (!output)
+    return;
+  auto refOutput = denoiseOnCPU(W, H, {{"conv2DBlocking", 0}}, filterParams);
+
+  size_t numErrors;
+  double avgError;
+  std::tie(numErrors, avgError) = compareImage(*output, *refOutput, 1e-4);
+  REQUIRE(numErrors == 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("AMX convolution", "[amx]")
+{
+  const int W = 257;
+  const int H = 89;
+
+  // On CPUs with AMX, the fast math convolutions compute in BF16 instead of using the Winograd
+  // algorithm in FP32, so only approximately the same output is expected
+  const ParamList filterParams = {{"quality", int(Quality::Balanced)}};
+  auto output = denoiseOnCPU(W, H, {}, filterParams);
+  if (!output)
+    return;
+  auto refOutput = denoiseOnCPU(W, H, {{"amx", 0}}, filterParams);
+
+  size_t numErrors;
+  double avgError;
+  std::tie(numErrors, avgError) = compareImage(*output, *refOutput, 0.01);
+  REQUIRE(numErrors == 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("fused convolutions", "[conv_fusion]")
+{
+  const int W = 257;
+  const int H = 89;
+
+  // The fused convolutions are used mostly at high quality
+  const ParamList filterParams = {{"quality", int(Quality::High)}};
+  auto output = denoiseOnCPU(W, H, {}, filterParams);
+  if (!output)
+    return;
+
+  auto testFusion = [&](const char* fusion)
+  {
+    auto refOutput = denoiseOnCPU(W, H, {{fusion, 0}}, filterParams);
+
+    size_t numErrors;
+    double avgError;
+    std::tie(numErrors, avgError) = compareImage(*output, *refOutput, 1e-4);
+    REQUIRE(numErrors == 0);
+  };
+
+  SECTION("concat")
+  {
+    // The decoder convolutions read the concatenated sources from separate tensors
+    testFusion("concatFusion");
+  }
+
+  SECTION("pool")
+  {
+    // The encoder convolutions pool their output before storing it
+    testFusion("poolFusion");
+  }
+
+  SECTION("upsample")
+  {
+    // The decoder convolutions upsample their first source on the fly
+    testFusion("upsampleFusion");
+  }
+
+  SECTION("output")
+  {
+    // The last convolution processes its output on the fly
+    testFusion("outputFusion");
+
+    // Also with pipelined tiles, where the fused output processing of a tile runs in the tail of
+    // the graph
+    const ParamList tiledFilterParams = {{"quality", int(Quality::High)}, {"maxMemoryMB", 20}};
+    const int tiledW = 1031;
+    const int tiledH = 323;
+    auto tiledOutput    = denoiseOnCPU(tiledW, tiledH, {}, tiledFilterParams);
+    auto tiledRefOutput = denoiseOnCPU(tiledW, tiledH, {{"outputFusion", 0}}, tiledFilterParams);
+
+    size_t numErrors;
+    double avgError;
+    std::tie(numErrors, avgError) = compareImage(*tiledOutput, *tiledRefOutput, 1e-4);
+    REQUIRE(numErrors == 0);
+  }
 }
 
 #endif // defined(OIDN_FILTER_RT)
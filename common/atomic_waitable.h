@@ -0,0 +1,109 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "common/platform.h"
+
+#include <thread>
+
+#if defined(__linux__)
+  #include <linux/futex.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#else
+  #include <mutex>
+  #include <condition_variable>
+#endif
+
+OIDN_NAMESPACE_BEGIN
+
+  // 32-bit atomic counter which threads can wait on until it changes, similar to the C++20
+  // std::atomic::wait and notify_all. It is implemented with futexes on Linux, and with a mutex and
+  // condition variable on other platforms. Notifying is only an atomic load if there are no waiting
+  // threads
+  class AtomicWaitable
+  {
+  public:
+    explicit AtomicWaitable(uint32_t value = 0) : value(value), numWaiters(0) {}
+
+    uint32_t load() const { return value.load(); }
+
+    // Adds to the value and wakes up all waiting threads
+    void add(uint32_t delta = 1)
+    {
+      value.fetch_add(delta);
+      notifyAll();
+    }
+
+    // Blocks while the value is equal to the specified old value (may return spuriously)
+    void wait(uint32_t oldValue)
+    {
+      // Spin (only if there are multiple hardware threads) and then yield for a short time before
+      // sleeping, which avoids the system calls for both the waiting and the notifying thread if
+      // the value changes soon
+      static const int numSpins = (std::thread::hardware_concurrency() > 1) ? maxNumSpins : 0;
+      for (int i = 0; i < numSpins + numYields; ++i)
+      {
+        if (value.load(std::memory_order_relaxed) != oldValue)
+          return;
+
+        if (i < numSpins)
+        {
+        #if defined(OIDN_ARCH_X64)
+          _mm_pause();
+        #endif
+        }
+        else
+          std::this_thread::yield();
+      }
+
+      // The waiter count must be incremented before checking the value, so either we see the new
+      // value or the notifying thread sees the waiter
+      numWaiters.fetch_add(1);
+    #if defined(__linux__)
+      if (value.load() == oldValue)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&value), FUTEX_WAIT_PRIVATE, oldValue,
+                nullptr, nullptr, 0);
+    #else
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (value.load() == oldValue)
+          cond.wait(lock);
+      }
+    #endif
+      numWaiters.fetch_sub(1);
+    }
+
+  private:
+    static constexpr int maxNumSpins = 64;
+    static constexpr int numYields   = 16;
+
+    // Disable copying
+    AtomicWaitable(const AtomicWaitable&) = delete;
+    AtomicWaitable& operator =(const AtomicWaitable&) = delete;
+
+    void notifyAll()
+    {
+      if (numWaiters.load() == 0)
+        return;
+
+    #if defined(__linux__)
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&value), FUTEX_WAKE_PRIVATE, INT_MAX,
+              nullptr, nullptr, 0);
+    #else
+      // Locking the mutex guarantees that the waiters are either blocked or will see the new value
+      { std::lock_guard<std::mutex> lock(mutex); }
+      cond.notify_all();
+    #endif
+    }
+
+    std::atomic<uint32_t> value; // must have the same layout as uint32_t for futexes
+    std::atomic<int> numWaiters;
+  #if !defined(__linux__)
+    std::mutex mutex;
+    std::condition_variable cond;
+  #endif
+  };
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,43 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "include/OpenImageDenoise/config.h"
+#include <cstdint>
+#include <cstring>
+
+OIDN_NAMESPACE_BEGIN
+
+  // Minimal bfloat16 data type (upper 16 bits of a float), used only for storing values
+  class bfloat16
+  {
+  public:
+    bfloat16() = default;
+    bfloat16(float f) : x(fromFloat(f)) {}
+
+    bfloat16& operator =(float f) { x = fromFloat(f); return *this; }
+
+    operator float() const
+    {
+      const uint32_t u = uint32_t(x) << 16;
+      float f;
+      std::memcpy(&f, &u, sizeof(f));
+      return f;
+    }
+
+  private:
+    // Rounds to nearest even, keeping NaNs quiet
+    static uint16_t fromFloat(float f)
+    {
+      uint32_t u;
+      std::memcpy(&u, &f, sizeof(u));
+      if ((u & 0x7fffffff) > 0x7f800000)
+        return uint16_t((u >> 16) | 0x40);
+      return uint16_t((u + 0x7fff + ((u >> 16) & 1)) >> 16);
+    }
+
+    uint16_t x;
+  };
+
+OIDN_NAMESPACE_END
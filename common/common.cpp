@@ -9,9 +9,11 @@ OIDN_NAMESPACE_BEGIN
   {
     switch (dataType)
     {
-    case DataType::UInt8:   return 1;
-    case DataType::Float16: return sizeof(int16_t);
-    case DataType::Float32: return sizeof(float);
+    case DataType::UInt8:    return 1;
+    case DataType::Int8:     return 1;
+    case DataType::Float16:  return sizeof(int16_t);
+    case DataType::Float32:  return sizeof(float);
+    case DataType::BFloat16: return sizeof(int16_t);
     default:
       throw std::invalid_argument("invalid data type");
     }
@@ -5,6 +5,7 @@
 
 #include "oidn_utils.h" // must be included before platform.h
 #include "platform.h"
+#include "bfloat16.h"
 
 OIDN_NAMESPACE_BEGIN
 
@@ -18,10 +19,12 @@ OIDN_NAMESPACE_BEGIN
   template<typename T>
   struct DataTypeOf;
 
-  template<> struct DataTypeOf<void>    { static constexpr DataType value = DataType::Void;    };
-  template<> struct DataTypeOf<uint8_t> { static constexpr DataType value = DataType::UInt8;   };
-  template<> struct DataTypeOf<half>    { static constexpr DataType value = DataType::Float16; };
-  template<> struct DataTypeOf<float>   { static constexpr DataType value = DataType::Float32; };
+  template<> struct DataTypeOf<void>     { static constexpr DataType value = DataType::Void;     };
+  template<> struct DataTypeOf<uint8_t>  { static constexpr DataType value = DataType::UInt8;    };
+  template<> struct DataTypeOf<int8_t>   { static constexpr DataType value = DataType::Int8;     };
+  template<> struct DataTypeOf<half>     { static constexpr DataType value = DataType::Float16;  };
+  template<> struct DataTypeOf<float>    { static constexpr DataType value = DataType::Float32;  };
+  template<> struct DataTypeOf<bfloat16> { static constexpr DataType value = DataType::BFloat16; };
 
   // Returns the size of a data type in bytes
   size_t getDataTypeSize(DataType dataType);
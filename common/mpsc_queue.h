@@ -0,0 +1,104 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "common/platform.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  // Lock-free bounded multi-producer single-consumer queue (ring buffer), based on the bounded MPMC
+  // queue by Dmitry Vyukov. Each slot has a sequence number which tells whether it is ready to be
+  // written by the producer owning the position, or to be read by the consumer
+  template<typename T>
+  class MPSCQueue
+  {
+  public:
+    // The capacity must be a power of 2
+    explicit MPSCQueue(size_t capacity)
+      : slots(new Slot[capacity]),
+        mask(capacity - 1),
+        tail(0),
+        head(0)
+    {
+      if (capacity < 2 || (capacity & mask) != 0)
+        throw std::invalid_argument("queue capacity must be a power of 2");
+
+      for (size_t i = 0; i < capacity; ++i)
+        slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    // Tries to push a value to the queue, returns false if the queue is full (thread-safe)
+    bool tryPush(T&& value)
+    {
+      Slot* slot;
+      size_t pos = tail.load(std::memory_order_relaxed);
+
+      for (; ;)
+      {
+        slot = &slots[pos & mask];
+        const size_t seq = slot->seq.load(std::memory_order_acquire);
+        const intptr_t diff = intptr_t(seq) - intptr_t(pos);
+
+        if (diff == 0)
+        {
+          // The slot is free, try to claim the position
+          if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            break;
+        }
+        else if (diff < 0)
+          return false; // full
+        else
+          pos = tail.load(std::memory_order_relaxed); // another producer claimed the position
+      }
+
+      slot->value = std::move(value);
+      slot->seq.store(pos + 1, std::memory_order_release); // publish to the consumer
+      return true;
+    }
+
+    // Tries to pop a value from the queue, returns false if the queue is empty (must be called
+    // only from the consumer thread)
+    bool tryPop(T& value)
+    {
+      Slot* slot = &slots[head & mask];
+      if (slot->seq.load(std::memory_order_acquire) != head + 1)
+        return false; // empty
+
+      value = std::move(slot->value);
+      slot->value = T(); // release the resources held by the value
+      slot->seq.store(head + mask + 1, std::memory_order_release); // free the slot for the next lap
+      head++;
+      return true;
+    }
+
+    // Returns the number of positions claimed by the producers so far, including the values which
+    // are being pushed
+    size_t getPushCount() const
+    {
+      return tail.load();
+    }
+
+  private:
+    // Disable copying
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator =(const MPSCQueue&) = delete;
+
+    struct Slot
+    {
+      std::atomic<size_t> seq;
+      T value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+
+    // The producer and consumer positions are on separate cache lines to avoid false sharing
+    char pad0[64];
+    std::atomic<size_t> tail; // next position to write (producers)
+    char pad1[64];
+    size_t head;              // next position to read (consumer)
+    char pad2[64];
+  };
+
+OIDN_NAMESPACE_END
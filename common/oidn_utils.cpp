@@ -99,6 +99,19 @@ OIDN_NAMESPACE_BEGIN
     return sm;
   }
 
+  std::ostream& operator <<(std::ostream& sm, Precision precision)
+  {
+    switch (precision)
+    {
+    case Precision::Default: sm << "default"; break;
+    case Precision::Int8:    sm << "int8";    break;
+    case Precision::FP16:    sm << "fp16";    break;
+    default:
+      throw std::invalid_argument("invalid precision mode");
+    }
+    return sm;
+  }
+
   std::ostream& operator <<(std::ostream& sm, const UUID& uuid)
   {
     auto flags = sm.flags();
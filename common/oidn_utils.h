@@ -18,6 +18,7 @@ OIDN_NAMESPACE_BEGIN
   std::istream& operator >>(std::istream& sm, DeviceType& deviceType);
 
   std::ostream& operator <<(std::ostream& sm, Quality quality);
+  std::ostream& operator <<(std::ostream& sm, Precision precision);
 
   std::ostream& operator <<(std::ostream& sm, const UUID& uuid);
   std::ostream& operator <<(std::ostream& sm, const LUID& luid);
@@ -246,6 +246,8 @@ OIDN_NAMESPACE_BEGIN
     UInt8,
     Float16,
     Float32,
+    Int8,
+    BFloat16,
   };
 
 #if !defined(OIDN_COMPILE_METAL_DEVICE)
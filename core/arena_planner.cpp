@@ -49,6 +49,17 @@ OIDN_NAMESPACE_BEGIN
     dirty = true;
   }
 
+  void ArenaPlanner::setAllocPersistent(int allocID)
+  {
+    checkAllocID(allocID);
+
+    Alloc* alloc = allocs[allocID].get();
+    alloc->firstOpID = 0;
+    alloc->lastOpID  = INT_MAX;
+
+    dirty = true;
+  }
+
   void ArenaPlanner::commit()
   {
     if (!dirty)
@@ -19,6 +19,10 @@ public:
   // allocations to be stored consecutively in memory
   void addDepAllocs(int opID, const std::vector<int>& allocIDs, bool concatAllocs = false);
 
+  // Makes an allocation live during all operations (e.g. if it's accessed concurrently with
+  // operations that are not its dependents)
+  void setAllocPersistent(int allocID);
+
   // Commits changes to the plan, after which it's possible to query the offsets of the allocations
   void commit();
 
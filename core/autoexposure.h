@@ -41,6 +41,14 @@ OIDN_NAMESPACE_BEGIN
     void setDst(const Ref<Record<float>>& dst) { this->dst = dst; }
     float* getDstPtr() const { return dst->getPtr(); }
 
+    bool getAccesses(std::vector<MemoryAccess>& accesses) const override
+    {
+      addAccess(accesses, src, false);
+      if (dst)
+        addAccess(accesses, dst->getPtr(), sizeof(float), true);
+      return true;
+    }
+
   protected:
     ImageDesc srcDesc;
     Ref<Image> src;
@@ -13,7 +13,8 @@ OIDN_NAMESPACE_BEGIN
         src1Desc.getH() != src2Desc.getH() ||
         src1Desc.getW() != src2Desc.getW() ||
         src1Desc.layout != src2Desc.layout ||
-        src1Desc.dataType != src2Desc.dataType)
+        src1Desc.dataType != src2Desc.dataType ||
+        batchSize < 1 || src1Desc.getH() % batchSize != 0)
       throw std::invalid_argument("invalid concat+conv source descriptor");
     if (weightDesc.getRank() != 4 || weightDesc.getI() != (src1Desc.getC() + src2Desc.getC()) ||
         weightDesc.getPaddedI() != (src1Desc.getPaddedC() + src2Desc.getPaddedC()))
@@ -21,12 +22,13 @@ OIDN_NAMESPACE_BEGIN
 
     TensorDims dstDims{weightDesc.getO(), src1Desc.getH(), src1Desc.getW()};
     TensorDims dstPaddedDims{weightDesc.getPaddedO(), src1Desc.getH(), src1Desc.getW()};
-    dstDesc = {dstDims, dstPaddedDims, src1Desc.layout, src1Desc.dataType};
+    dstDesc = {dstDims, dstPaddedDims, src1Desc.layout, dstDataType};
   }
 
   void ConcatConv::setSrc(const Ref<Tensor>& src1, const Ref<Tensor>& src2)
   {
-    if (!src1 || src1->getDesc() != src1Desc || !src2 || src2->getDesc() != src2Desc)
+    if (!src1 || src1->getDesc() != (upsampleSrc1 ? getUpsampleSrcDesc(src1Desc) : src1Desc) ||
+        !src2 || src2->getDesc() != src2Desc)
       throw std::invalid_argument("invalid concat+conv source");
 
     this->src1 = src1;
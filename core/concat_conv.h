@@ -16,6 +16,9 @@ OIDN_NAMESPACE_BEGIN
     TensorDesc biasDesc;
     Activation activation;
     bool fastMath; // prefer performance over accuracy
+    int batchSize; // number of images stacked in the H dimension of the sources
+    DataType dstDataType; // may differ from the source data type only for quantized sources
+    bool upsampleSrc1; // src1 is stored at half resolution and upsampled 2x on the fly
   };
 
   class ConcatConv : public BaseOp, protected ConcatConvDesc
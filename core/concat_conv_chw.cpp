@@ -12,15 +12,38 @@ OIDN_NAMESPACE_BEGIN
     if (src1Desc.layout == TensorLayout::hwc)
       throw std::invalid_argument("unsupported concat+conv source layout");
 
-    TensorDims srcDims{src1Desc.getC() + src2Desc.getC(), src1Desc.getH(), src1Desc.getW()};
-    TensorDims srcPaddedDims{src1Desc.getPaddedC() + src2Desc.getPaddedC(), src1Desc.getH(), src1Desc.getW()};
-    srcDesc = {srcDims, srcPaddedDims, src1Desc.layout, src1Desc.dataType};
+    const ConvDesc convDesc = getConvDesc(desc);
+    srcDesc = convDesc.srcDesc;
+    conv = engine->newConv(convDesc);
 
-    conv = engine->newConv({srcDesc, weightDesc, biasDesc, activation, PostOp::None, fastMath});
+    if (upsampleSrc1 && !conv->isSrc2Supported())
+      throw std::logic_error("concat+conv source upsampling requires two convolution sources");
+  }
+
+  ConvDesc ConcatConvCHW::getConvDesc(const ConcatConvDesc& desc)
+  {
+    TensorDims srcDims{desc.src1Desc.getC() + desc.src2Desc.getC(), desc.src1Desc.getH(), desc.src1Desc.getW()};
+    TensorDims srcPaddedDims{desc.src1Desc.getPaddedC() + desc.src2Desc.getPaddedC(),
+                             desc.src1Desc.getH(), desc.src1Desc.getW()};
+    TensorDesc srcDesc = {srcDims, srcPaddedDims, desc.src1Desc.layout, desc.src1Desc.dataType};
+
+    return {srcDesc, desc.weightDesc, desc.biasDesc, desc.activation, PostOp::None, desc.fastMath,
+            desc.batchSize, desc.dstDataType, desc.upsampleSrc1, false};
+  }
+
+  bool ConcatConvCHW::isConvSupported(Engine* engine, const ConcatConvDesc& desc)
+  {
+    return engine->isConvSupported(getConvDesc(desc));
   }
 
   void ConcatConvCHW::updateSrc()
   {
+    if (conv->isSrc2Supported())
+    {
+      conv->setSrc(src1, src2);
+      return;
+    }
+
     if (!src1->getBuffer() || !src2->getBuffer())
       throw std::invalid_argument("concat+conv sources must be backed by buffers");
     if (src1->getBuffer() != src2->getBuffer() ||
@@ -7,24 +7,44 @@
 
 OIDN_NAMESPACE_BEGIN
 
-  // Concatenation + convolution for CHW tensors (including blocked) stored consecutively in memory
-  // Since the tensors are pre-concatenated in memory, only the convolution needs to be executed
+  // Concatenation + convolution for CHW tensors (including blocked)
+  // If the convolution can read the channels from two sources, the sources can be stored anywhere,
+  // otherwise they must be stored consecutively in memory (pre-concatenated), so only the
+  // convolution needs to be executed. Upsampling the first source on the fly requires reading the
+  // channels from two sources
   class ConcatConvCHW final : public ConcatConv
   {
   public:
     ConcatConvCHW(Engine* engine, const ConcatConvDesc& desc);
 
+    // Returns whether the engine supports the convolution required by the descriptor (e.g. with
+    // upsampling of the first source)
+    static bool isConvSupported(Engine* engine, const ConcatConvDesc& desc);
+
     Engine* getEngine() const override { return conv->getEngine(); }
 
     size_t getScratchByteSize() override { return conv->getScratchByteSize(); }
     void setScratch(const Ref<Buffer>& scratch) override { conv->setScratch(scratch); }
 
+    // Whether the sources must be stored consecutively in memory
+    bool isSrcConcatRequired() const { return !conv->isSrc2Supported(); }
+
+    TensorDesc getWeightDesc() const { return conv->getWeightDesc(); }
     void setWeight(const Ref<Tensor>& weight) { conv->setWeight(weight); }
+    TensorDesc getWeightScaleDesc() const { return conv->getWeightScaleDesc(); }
+    void setWeightScale(const Ref<Tensor>& weightScale) { conv->setWeightScale(weightScale); }
+
+    bool getAccesses(std::vector<MemoryAccess>& accesses) const override
+    {
+      return conv->getAccesses(accesses);
+    }
 
     void finalize() override { conv->finalize(); }
     void submitKernels(const Ref<CancellationToken>& ct) override { conv->submitKernels(ct); }
 
   private:
+    static ConvDesc getConvDesc(const ConcatConvDesc& desc);
+
     void updateSrc() override;
     void updateBias() override { conv->setBias(bias); }
     void updateDst() override { conv->setDst(dst); }
@@ -11,6 +11,8 @@ OIDN_NAMESPACE_BEGIN
   {
     if (src1Desc.layout != TensorLayout::hwc)
       throw std::logic_error("unsupported concat+conv source layout");
+    if (upsampleSrc1)
+      throw std::logic_error("concat+conv source upsampling is not supported");
 
     // Split the convolution into two smaller convolutions
     weight1Desc = {{dstDesc.getC(),       src1Desc.getC(),       weightDesc.getH(), weightDesc.getW()},
@@ -24,11 +26,13 @@ OIDN_NAMESPACE_BEGIN
                    weightDesc.dataType};
 
     // Convolution 1: dst = conv(src1, weight1) + bias
-    conv1 = engine->newConv({src1Desc, weight1Desc, biasDesc, Activation::None, PostOp::None, fastMath});
+    conv1 = engine->newConv({src1Desc, weight1Desc, biasDesc, Activation::None, PostOp::None, fastMath, batchSize,
+                             dstDesc.dataType, false, false});
 
     // Convolution 2: dst = activation(conv(src2, weight2) + dst)
     // We use dst as bias
-    conv2 = engine->newConv({src2Desc, weight2Desc, dstDesc, activation, PostOp::None, fastMath});
+    conv2 = engine->newConv({src2Desc, weight2Desc, dstDesc, activation, PostOp::None, fastMath, batchSize,
+                             dstDesc.dataType, false, false});
   }
 
   bool ConcatConvHWC::isSupported() const
@@ -25,6 +25,11 @@ OIDN_NAMESPACE_BEGIN
     TensorDesc getWeight2Desc() const { return weight2Desc; }
     void setWeight(const Ref<Tensor>& weight1, const Ref<Tensor>& weight2);
 
+    bool getAccesses(std::vector<MemoryAccess>& accesses) const override
+    {
+      return conv1->getAccesses(accesses) && conv2->getAccesses(accesses);
+    }
+
     void finalize() override;
     void submitKernels(const Ref<CancellationToken>& ct) override;
 
@@ -8,12 +8,18 @@ OIDN_NAMESPACE_BEGIN
   Conv::Conv(const ConvDesc& desc)
     : ConvDesc(desc)
   {
-    if (srcDesc.getRank() != 3)
+    if (srcDesc.getRank() != 3 || batchSize < 1 || srcDesc.getH() % batchSize != 0)
       throw std::invalid_argument("invalid convolution source shape");
     if (weightDesc.getRank() != 4 ||
         weightDesc.getI() != srcDesc.getC() ||
         weightDesc.getPaddedI() != srcDesc.getPaddedC())
       throw std::invalid_argument("invalid convolution weight shape");
+    if (dstDataType != srcDesc.dataType && srcDesc.dataType != DataType::UInt8)
+      throw std::invalid_argument("invalid convolution destination data type");
+    if (upsampleSrc && ((srcDesc.getH() / batchSize) % 2 != 0 || srcDesc.getW() % 2 != 0))
+      throw std::invalid_argument("invalid upsampling convolution source shape");
+    if (processDst && postOp != PostOp::None)
+      throw std::invalid_argument("processed convolution destination cannot have a postop");
 
     TensorDims dstDims;
     switch (postOp)
@@ -23,7 +29,7 @@ OIDN_NAMESPACE_BEGIN
       break;
 
     case PostOp::Pool:
-      if (srcDesc.getH() % 2 != 0 || srcDesc.getW() % 2 != 0)
+      if ((srcDesc.getH() / batchSize) % 2 != 0 || srcDesc.getW() % 2 != 0)
         throw std::invalid_argument("invalid pooling source shape");
       dstDims = {weightDesc.getO(), srcDesc.getH() / 2, srcDesc.getW() / 2};
       break;
@@ -39,7 +45,7 @@ OIDN_NAMESPACE_BEGIN
     TensorDims dstPaddedDims = dstDims;
     dstPaddedDims[0] = weightDesc.getPaddedO();
 
-    dstDesc = {dstDims, dstPaddedDims, srcDesc.layout, srcDesc.dataType};
+    dstDesc = {dstDims, dstPaddedDims, srcDesc.layout, dstDataType};
 
     if (!((biasDesc.getRank() == 1 && biasDesc.getX() == weightDesc.getO()
                                    && biasDesc.getPaddedX() == weightDesc.getPaddedO()) ||
@@ -50,10 +56,33 @@ OIDN_NAMESPACE_BEGIN
 
   void Conv::setSrc(const Ref<Tensor>& src)
   {
-    if (!src || src->getDesc() != srcDesc)
+    if (!src || src->getDesc() != (upsampleSrc ? getUpsampleSrcDesc(srcDesc) : srcDesc))
       throw std::invalid_argument("invalid convolution source");
 
-    this->src = src;
+    this->src  = src;
+    this->src2 = nullptr;
+    updateSrc();
+  }
+
+  void Conv::setSrc(const Ref<Tensor>& src1, const Ref<Tensor>& src2)
+  {
+    if (!isSrc2Supported())
+      throw std::logic_error("convolution does not support two sources");
+
+    // The first source may be stored at half resolution (upsampled on the fly)
+    auto isValidSrc = [&](const Ref<Tensor>& src, int scale)
+    {
+      return src && src->getRank() == 3 &&
+             src->getH() * scale == srcDesc.getH() && src->getW() * scale == srcDesc.getW() &&
+             src->getLayout() == srcDesc.layout && src->getDataType() == srcDesc.dataType;
+    };
+
+    if (!isValidSrc(src1, upsampleSrc ? 2 : 1) || !isValidSrc(src2, 1) ||
+        src1->getPaddedC() + src2->getPaddedC() != srcDesc.getPaddedC())
+      throw std::invalid_argument("invalid convolution sources");
+
+    this->src  = src1;
+    this->src2 = src2;
     updateSrc();
   }
 
@@ -75,8 +104,25 @@ OIDN_NAMESPACE_BEGIN
     updateBias();
   }
 
+  TensorDesc Conv::getWeightScaleDesc() const
+  {
+    return {{weightDesc.getO()}, {weightDesc.getPaddedO()}, TensorLayout::x, DataType::Float32};
+  }
+
+  void Conv::setWeightScale(const Ref<Tensor>& weightScale)
+  {
+    if (weightDesc.dataType != DataType::Int8)
+      throw std::logic_error("convolution weights are not quantized");
+    if (!weightScale || weightScale->getDesc() != getWeightScaleDesc())
+      throw std::invalid_argument("invalid convolution weight scale");
+
+    this->weightScale = weightScale;
+  }
+
   void Conv::setDst(const Ref<Tensor>& dst)
   {
+    if (processDst)
+      throw std::logic_error("convolution destination must be passed to output processing");
     if (!dst || dst->getDesc() != dstDesc)
       throw std::invalid_argument("invalid convolution destination");
 
@@ -84,4 +130,28 @@ OIDN_NAMESPACE_BEGIN
     updateDst();
   }
 
+  void Conv::setDst(const Ref<OutputProcess>& dstProcess)
+  {
+    if (!processDst)
+      throw std::logic_error("convolution does not support processing the destination");
+    if (!dstProcess || dstProcess->getSrcDesc() != dstDesc)
+      throw std::invalid_argument("invalid convolution destination output processing");
+
+    this->dstProcess = dstProcess;
+    updateDst();
+  }
+
+  bool Conv::getAccesses(std::vector<MemoryAccess>& accesses) const
+  {
+    addAccess(accesses, src, false);
+    addAccess(accesses, src2, false);
+    addAccess(accesses, weight, false);
+    addAccess(accesses, weightScale, false);
+    addAccess(accesses, bias, false);
+    addAccess(accesses, dst, true);
+    if (dstProcess)
+      dstProcess->getDstAccesses(accesses);
+    return true;
+  }
+
 OIDN_NAMESPACE_END
@@ -5,6 +5,7 @@
 
 #include "op.h"
 #include "tensor.h"
+#include "output_process.h"
 
 OIDN_NAMESPACE_BEGIN
 
@@ -31,8 +32,21 @@ OIDN_NAMESPACE_BEGIN
     Activation activation;
     PostOp postOp;
     bool fastMath; // prefer performance over accuracy
+    int batchSize; // number of images stacked in the H dimension of the source
+    DataType dstDataType; // may differ from the source data type only for quantized sources
+    bool upsampleSrc; // the first source is stored at half resolution and upsampled 2x on the fly
+    bool processDst;  // the destination is the source of output processing, computed on the fly
   };
 
+  // Returns the descriptor of a source at half resolution, which is upsampled 2x (nearest) to the
+  // specified descriptor
+  inline TensorDesc getUpsampleSrcDesc(const TensorDesc& desc)
+  {
+    return {{desc.getC(),       desc.getH() / 2, desc.getW() / 2},
+            {desc.getPaddedC(), desc.getH() / 2, desc.getW() / 2},
+            desc.layout, desc.dataType};
+  }
+
   // Convolution
   class Conv : public BaseOp, protected ConvDesc
   {
@@ -42,11 +56,30 @@ OIDN_NAMESPACE_BEGIN
     TensorDesc getDstDesc() const { return dstDesc; }
     Ref<Tensor> getDst() const { return dst; }
 
+    // The required weight format may differ from the specified one (e.g. transformed weights)
+    TensorDesc getWeightDesc() const { return weightDesc; }
+
     void setSrc(const Ref<Tensor>& src);
+
+    // Some convolutions can read the source channels from two tensors instead of one, which avoids
+    // having to store the concatenated sources consecutively in memory
+    virtual bool isSrc2Supported() const { return false; }
+    void setSrc(const Ref<Tensor>& src1, const Ref<Tensor>& src2);
+
     void setWeight(const Ref<Tensor>& weight);
     void setBias(const Ref<Tensor>& bias);
     void setDst(const Ref<Tensor>& dst);
 
+    // Sets the output processing which is applied to the destination on the fly (requires
+    // processDst), so the destination does not have to be stored in memory
+    void setDst(const Ref<OutputProcess>& dstProcess);
+
+    // Quantized (int8) weights have a dequantization scale for each output channel
+    TensorDesc getWeightScaleDesc() const;
+    void setWeightScale(const Ref<Tensor>& weightScale);
+
+    bool getAccesses(std::vector<MemoryAccess>& accesses) const override;
+
   protected:
     virtual void updateSrc() {}
     virtual void updateWeight() {}
@@ -55,9 +88,12 @@ OIDN_NAMESPACE_BEGIN
 
     TensorDesc dstDesc;
     Ref<Tensor> src;
+    Ref<Tensor> src2; // optional, contains the channels following the channels of src
     Ref<Tensor> weight;
+    Ref<Tensor> weightScale;
     Ref<Tensor> bias;
     Ref<Tensor> dst;
+    Ref<OutputProcess> dstProcess; // processes the destination instead of storing it (optional)
   };
 
 OIDN_NAMESPACE_END
@@ -197,6 +197,21 @@ OIDN_NAMESPACE_BEGIN
       return managedMemorySupported;
     else if (name == "externalMemoryTypes")
       return static_cast<int>(externalMemoryTypes);
+    else if (name == "planCacheHits")
+      return planCache.getNumHits();
+    else if (name == "planCacheMisses")
+      return planCache.getNumMisses();
+    else if (name == "weightsCacheHits" || name == "weightsCacheMisses")
+    {
+      int numAccesses = 0;
+      for (const auto& subdevice : subdevices)
+      {
+        const WeightsCache& weightsCache = subdevice->getWeightsCache();
+        numAccesses += (name == "weightsCacheHits") ? weightsCache.getNumHits()
+                                                    : weightsCache.getNumMisses();
+      }
+      return numAccesses;
+    }
     else
       throw Exception(Error::InvalidArgument, "unknown device parameter or type mismatch: '" + name + "'");
   }
@@ -253,6 +268,11 @@ OIDN_NAMESPACE_BEGIN
     return getSubdevice(i)->getEngine();
   }
 
+  Engine* Device::getStreamEngine(int stream, int i) const
+  {
+    return getStreamSubdevice(stream, i)->getEngine();
+  }
+
   Ref<Buffer> Device::newUserBuffer(size_t byteSize, Storage storage)
   {
     return getEngine()->newBuffer(byteSize, storage)->toUser();
@@ -319,10 +339,55 @@ OIDN_NAMESPACE_BEGIN
     syncAndThrow(sync);
   }
 
+  void Device::execute(int stream, std::function<void()>&& f, SyncMode sync)
+  {
+    if (numStreams == 1 || sync != SyncMode::Blocking)
+    {
+      execute(std::move(f), sync);
+      return;
+    }
+
+    try
+    {
+      f();
+    }
+    catch (...)
+    {
+      // Make sure to synchronize even if an exception has been thrown
+      waitStreamAndThrow(stream);
+      throw;
+    }
+
+    waitStreamAndThrow(stream);
+  }
+
   void Device::waitAndThrow()
   {
     wait();
+    throwAsyncError();
+  }
+
+  void Device::waitStreamAndThrow(int stream)
+  {
+    // Other threads may submit commands to other streams while waiting, so the device is unlocked,
+    // and locked again even if waiting throws an exception
+    {
+      struct Unlock
+      {
+        std::mutex& mutex;
+        explicit Unlock(std::mutex& mutex) : mutex(mutex) { mutex.unlock(); }
+        ~Unlock() { mutex.lock(); }
+      } unlock(mutex);
+
+      for (int i = 0; i < getNumStreamSubdevices(); ++i)
+        getStreamEngine(stream, i)->wait();
+    }
+
+    throwAsyncError();
+  }
 
+  void Device::throwAsyncError()
+  {
     // If an asynchronous error was stored, throw it now
     std::lock_guard<std::mutex> asyncErrorLock(asyncErrorMutex);
     if (asyncError.code != Error::None)
@@ -10,6 +10,8 @@
 #include "thread.h"
 #include "tensor_layout.h"
 #include "data.h"
+#include "plan_cache.h"
+#include "tuning_cache.h"
 #include <functional>
 
 OIDN_NAMESPACE_BEGIN
@@ -92,6 +94,17 @@ OIDN_NAMESPACE_BEGIN
     int getNumSubdevices() const { return static_cast<int>(subdevices.size()); }
     Engine* getEngine(int i = 0) const;
 
+    // Streams
+    // The subdevices are partitioned into streams with separate engines and resources, so filters
+    // executed on different streams can run concurrently
+    int getNumStreams() const { return numStreams; }
+    int getNumStreamSubdevices() const { return getNumSubdevices() / numStreams; }
+    Subdevice* getStreamSubdevice(int stream, int i = 0) const
+    {
+      return getSubdevice(stream * getNumStreamSubdevices() + i);
+    }
+    Engine* getStreamEngine(int stream, int i = 0) const;
+
     oidn_inline std::mutex& getMutex() { return mutex; }
 
     // Native tensor layout
@@ -110,12 +123,22 @@ OIDN_NAMESPACE_BEGIN
     ExternalMemoryTypeFlags getExternalMemoryTypes() const { return externalMemoryTypes; }
     void trimScratch();
 
+    // Cache of the execution plans of filters
+    PlanCache& getPlanCache() { return planCache; }
+
+    // Persistent cache of the autotuned tile plans of filters
+    TuningCache& getTuningCache() { return tuningCache; }
+
     // Executes operations on the device, making sure to wait/flush and release temporary
     // allocations (e.g. from ObjC) at the end, even if an exception is thrown
     virtual void execute(std::function<void()>&& f, SyncMode sync = SyncMode::Blocking);
 
-    // Synchronizes all subdevices (does not block)
-    virtual void submitBarrier() {}
+    // Executes operations on a stream like execute(), but waits only for the stream if there are
+    // multiple streams, unlocking the device while waiting (the device must be locked)
+    void execute(int stream, std::function<void()>&& f, SyncMode sync = SyncMode::Blocking);
+
+    // Synchronizes all subdevices of a stream (does not block)
+    virtual void submitBarrier(int stream = 0) {}
 
     // Issues all previously submitted commands (does not block)
     virtual void flush() {}
@@ -133,7 +156,8 @@ OIDN_NAMESPACE_BEGIN
   protected:
     virtual void init() = 0;
 
-    std::vector<std::unique_ptr<Subdevice>> subdevices;
+    std::vector<std::unique_ptr<Subdevice>> subdevices; // ordered by stream
+    int numStreams = 1;
 
     // Native tensor layout
     DataType tensorDataType = DataType::Float32;
@@ -152,6 +176,13 @@ OIDN_NAMESPACE_BEGIN
     bool committed = false;
 
   private:
+    // Waits for all previously submitted commands to a stream to complete with the device
+    // unlocked, and throws the first asynchronous error like waitAndThrow() (blocks)
+    void waitStreamAndThrow(int stream);
+
+    // Throws the first asynchronous error that occured since the previous invocation
+    void throwAsyncError();
+
     // Thread-safety
     std::mutex mutex;
 
@@ -170,6 +201,9 @@ OIDN_NAMESPACE_BEGIN
 
     ErrorFunction errorFunc = nullptr;
     void* errorUserPtr = nullptr;
+
+    PlanCache planCache;
+    TuningCache tuningCache{getEnvVarOrDefault<std::string>("OIDN_TUNING_CACHE", "")};
   };
 
   // SYCL devices require additional methods exposed for the API implementation
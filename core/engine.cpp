@@ -3,6 +3,8 @@
 
 #include "engine.h"
 #include "conv.h"
+#include "tile_variance.h"
+#include "tile_pass_through.h"
 
 OIDN_NAMESPACE_BEGIN
 
@@ -83,9 +85,45 @@ OIDN_NAMESPACE_BEGIN
     return makeRef<DeviceTensor>(buffer, desc, byteOffset);
   }
 
-  bool Engine::isConvSupported(PostOp postOp)
+  bool Engine::isConvSupported(const ConvDesc& desc)
   {
-    return postOp == PostOp::None;
+    return desc.postOp == PostOp::None && !desc.upsampleSrc && !desc.processDst;
+  }
+
+  bool Engine::isBatchSupported() const
+  {
+    return false;
+  }
+
+  bool Engine::isPrecisionSupported(Precision precision) const
+  {
+    return precision == Precision::Default;
+  }
+
+  bool Engine::isTileVarianceSupported() const
+  {
+    return false;
+  }
+
+  Ref<TileVariance> Engine::newTileVariance()
+  {
+    throw std::logic_error("tile variance is not supported by the device");
+  }
+
+  Ref<TilePassThrough> Engine::newTilePassThrough(const TilePassThroughDesc& desc)
+  {
+    throw std::logic_error("tile pass-through is not supported by the device");
+  }
+
+  bool Engine::isConcurrencySupported() const
+  {
+    return false;
+  }
+
+  size_t Engine::submitDepthFirst(const std::vector<Ref<Op>>& ops, size_t begin, size_t end,
+                                  const Ref<Progress>& progress)
+  {
+    return 0;
   }
 
   void* Engine::usmAlloc(size_t byteSize, Storage storage)
@@ -21,6 +21,7 @@ OIDN_NAMESPACE_BEGIN
   struct OutputProcessDesc;
 
   enum class PostOp;
+  class Op;
   class Conv;
   class ConcatConv;
   class Pool;
@@ -30,6 +31,17 @@ OIDN_NAMESPACE_BEGIN
   class InputProcess;
   class OutputProcess;
   class ImageCopy;
+  class TileVariance;
+  class TilePassThrough;
+  struct TilePassThroughDesc;
+
+  // Range of memory read or written by a command
+  struct MemoryAccess
+  {
+    const void* begin;
+    const void* end;
+    bool write;
+  };
 
   // Execution engine of a subdevice
   class Engine
@@ -65,7 +77,9 @@ OIDN_NAMESPACE_BEGIN
     virtual Ref<Tensor> newTensor(const Ref<Buffer>& buffer, const TensorDesc& desc, size_t byteOffset = 0);
 
     // Ops
-    virtual bool isConvSupported(PostOp postOp);
+    virtual bool isConvSupported(const ConvDesc& desc); // including the postop
+    virtual bool isBatchSupported() const; // whether ops support images stacked in a batch
+    virtual bool isPrecisionSupported(Precision precision) const; // supported tensor precisions
     virtual Ref<Conv> newConv(const ConvDesc& desc) = 0;
     virtual Ref<Pool> newPool(const PoolDesc& desc) = 0;
     virtual Ref<Upsample> newUpsample(const UpsampleDesc& desc) = 0;
@@ -73,6 +87,15 @@ OIDN_NAMESPACE_BEGIN
     virtual Ref<InputProcess> newInputProcess(const InputProcessDesc& desc) = 0;
     virtual Ref<OutputProcess> newOutputProcess(const OutputProcessDesc& desc) = 0;
     virtual Ref<ImageCopy> newImageCopy() = 0;
+    virtual bool isTileVarianceSupported() const; // optional ops for skipping constant tiles
+    virtual Ref<TileVariance> newTileVariance();
+    virtual Ref<TilePassThrough> newTilePassThrough(const TilePassThroughDesc& desc);
+
+    // Submits the ops in [begin, end), where each op consumes only the output of the previous one,
+    // in depth-first order if supported (i.e. computing bands of rows through multiple ops at a time)
+    // Returns the number of ops submitted from the beginning of the chain (0 if not supported)
+    virtual size_t submitDepthFirst(const std::vector<Ref<Op>>& ops, size_t begin, size_t end,
+                                    const Ref<Progress>& progress);
 
     // Unified shared memory (USM)
     virtual void* usmAlloc(size_t byteSize, Storage storage);
@@ -84,6 +107,24 @@ OIDN_NAMESPACE_BEGIN
     virtual void submitHostFunc(std::function<void()>&& f,
                                 const Ref<CancellationToken>& ct = nullptr) = 0;
 
+    // Commands submitted between beginConcurrent() and endConcurrent() may run concurrently with
+    // commands submitted later, until a join is submitted (if concurrency is not supported, all
+    // commands are executed in order)
+    virtual bool isConcurrencySupported() const;
+    virtual void beginConcurrent() {}
+    virtual void endConcurrent() {}
+
+    // Enqueues a join, which waits for all previously submitted concurrent commands to complete
+    virtual void submitJoin() {}
+
+    // Commands submitted by the current thread between beginAccesses() and endAccesses() access
+    // only the specified memory ranges, so they may run concurrently with commands accessing
+    // non-overlapping memory if dependency tracking is supported (otherwise all commands are
+    // assumed to access any memory)
+    virtual bool isDependencyTrackingSupported() const { return false; }
+    virtual void beginAccesses(const std::vector<MemoryAccess>& accesses) {}
+    virtual void endAccesses() {}
+
     // Issues all previously submitted commands (does not block)
     virtual void flush() {}
 
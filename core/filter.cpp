@@ -38,6 +38,12 @@ OIDN_NAMESPACE_BEGIN
     dst = src;
   }
 
+  void Filter::setParam(Precision& dst, Precision src)
+  {
+    dirtyParam |= dst != src;
+    dst = src;
+  }
+
   void Filter::setParam(Ref<Image>& dst, const Ref<Image>& src)
   {
     // Check whether the image is accessible by the device
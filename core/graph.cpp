@@ -7,6 +7,7 @@
 #include "concat_conv_chw.h"
 #include "concat_conv_hwc.h"
 #include "tensor_reorder.h"
+#include "tza.h"
 #if defined(OIDN_MICROBENCH)
   #include "common/timer.h"
 #endif
@@ -16,21 +17,38 @@ OIDN_NAMESPACE_BEGIN
   Graph::Graph(Engine* engine,
                const std::shared_ptr<TensorMap>& constTensors,
                const std::shared_ptr<TensorMap>& cachedConstTensors,
-               bool fastMath)
+               bool fastMath,
+               Precision precision)
     : engine(engine),
       constTensors(constTensors),
       cachedConstTensors(cachedConstTensors),
-      fastMath(fastMath) {}
+      fastMath(fastMath),
+      precision(precision) {}
 
   Ref<InputProcess> Graph::addInputProcess(const std::string& name,
                                            const TensorDims& srcDims,
+                                           int batchSize,
                                            const std::shared_ptr<TransferFunction>& transferFunc,
                                            bool hdr,
                                            bool snorm)
   {
-    auto op = engine->newInputProcess({srcDims, transferFunc, hdr, snorm});
+    if (!ops.empty())
+      throw std::logic_error("input processing must be the first operation in the graph");
+
+    this->batchSize = batchSize;
+    DataType dstDataType;
+    switch (precision)
+    {
+    case Precision::Int8: dstDataType = DataType::UInt8;   break;
+    case Precision::FP16: dstDataType = DataType::Float16; break;
+    default:              dstDataType = engine->getDevice()->getTensorDataType();
+    }
+    auto op = engine->newInputProcess({srcDims, batchSize, transferFunc, hdr, snorm, dstDataType});
     op->setName(name);
     auto dstAlloc = addOp(op, {}, op->getDstDesc());
+    if (dstDataType == DataType::UInt8)
+      dstAlloc->scale = 1.f / 255.f;
+    inputAllocID = dstAlloc->id;
 
     lazyInits.push_back([=]()
     {
@@ -46,10 +64,30 @@ OIDN_NAMESPACE_BEGIN
                                              bool hdr,
                                              bool snorm)
   {
-    auto srcAlloc = tensorAllocs[srcOp.get()];
-    auto op = engine->newOutputProcess({srcAlloc->desc, transferFunc, hdr, snorm});
+    // The source may be a deferred convolution, which passes its output to the output processing
+    // on the fly if supported, so the output of the convolution is not stored in memory
+    if (deferredConv.op && srcOp.get() == deferredConv.op.get())
+    {
+      auto op = engine->newOutputProcess({deferredConv.op->getDstDesc(), batchSize, transferFunc,
+                                          hdr, snorm});
+      op->setName(name);
+      addDeferredConv(op);
+      outputFused = true;
+      return op;
+    }
+
+    auto srcAlloc = getSrcAlloc(srcOp);
+    if (srcAlloc->desc.dataType == DataType::UInt8)
+      throw std::invalid_argument("output processing does not support quantized sources");
+    auto op = engine->newOutputProcess({srcAlloc->desc, batchSize, transferFunc, hdr, snorm});
     op->setName(name);
     addOp(op, {srcOp});
+    outputSrcAllocID = srcAlloc->id;
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+      if (ops[i] == srcOp)
+        outputSrcOpID = i;
+    }
 
     lazyInits.push_back([=]()
     {
@@ -64,21 +102,6 @@ OIDN_NAMESPACE_BEGIN
                          Activation activation,
                          PostOp postOp)
   {
-    if (postOp != PostOp::None && !engine->isConvSupported(postOp))
-    {
-      // If the engine does not support the specified fused convolution, split it into two ops
-      auto conv = addConv(name, srcOp, activation, PostOp::None);
-      switch (postOp)
-      {
-      case PostOp::Pool:
-        return addPool(name + "_pool", conv);
-      case PostOp::Upsample:
-        return addUpsample(name + "_upsample", conv);
-      default:
-        throw std::invalid_argument("cannot split fused convolution");
-      }
-    }
-
     const std::string weightName = name + ".weight";
     const std::string biasName   = name + ".bias";
     Ref<Tensor> weight = (*constTensors)[weightName];
@@ -105,41 +128,152 @@ OIDN_NAMESPACE_BEGIN
                                 TensorLayout::x,
                                 device->getTensorDataType()};
 
-    auto srcAlloc = tensorAllocs[srcOp.get()];
-    auto conv = engine->newConv({srcAlloc->desc, finalWeightDesc, finalBiasDesc, activation, postOp, fastMath});
+    // Quantized sources are convolved with int8 weights, and the destination is quantized too if
+    // its scale is known (otherwise it is stored in floating-point)
+    auto srcAlloc = getSrcAlloc(srcOp);
+    const bool quantized = srcAlloc->desc.dataType == DataType::UInt8;
+    const float dstScale = quantized ? getDstScale(name) : 0.f;
+    DataType dstDataType = srcAlloc->desc.dataType;
+    if (quantized)
+    {
+      finalWeightDesc.dataType = DataType::Int8;
+      finalBiasDesc.dataType = DataType::Float32;
+      dstDataType = (dstScale > 0.f) ? DataType::UInt8 : DataType::Float32;
+    }
+
+    const ConvDesc convDesc{srcAlloc->desc, finalWeightDesc, finalBiasDesc, activation, postOp, fastMath,
+                            batchSize, dstDataType, false, false};
+
+    if (postOp != PostOp::None && !engine->isConvSupported(convDesc))
+    {
+      // If the engine does not support the specified fused convolution, split it into two ops
+      auto conv = addConv(name, srcOp, activation, PostOp::None);
+      switch (postOp)
+      {
+      case PostOp::Pool:
+        return addPool(name + "_pool", conv);
+      case PostOp::Upsample:
+      {
+        // Defer adding the upsampling until its output is used, as it may be fused into the
+        // consuming op
+        auto upsample = engine->newUpsample({getSrcAlloc(conv)->desc});
+        upsample->setName(name + "_upsample");
+        deferredUpsamples[upsample.get()] = {upsample, conv};
+        return upsample;
+      }
+      default:
+        throw std::invalid_argument("cannot split fused convolution");
+      }
+    }
+
+    auto conv = engine->newConv(convDesc);
     conv->setName(name);
-    auto dstAlloc = addOp(conv, {srcOp}, conv->getDstDesc());
 
-    lazyInits.push_back([=]()
+    if (quantized)
     {
-      conv->setSrc(srcAlloc->tensor);
-      conv->setDst(dstAlloc->tensor);
+      finalWeightDesc = conv->getWeightDesc(); // the convolution may require a different weight format
+      const TensorDesc finalWeightScaleDesc = conv->getWeightScaleDesc();
+      auto dstAlloc = addOp(conv, {srcOp}, conv->getDstDesc());
+      dstAlloc->scale = dstScale;
 
-      Ref<Tensor> finalWeight = getCachedConstTensor(weightName, finalWeightDesc);
-      if (!finalWeight)
+      lazyInits.push_back([=]()
       {
-        finalWeight = makeRef<HostTensor>(finalWeightDesc);
-        reorderWeight(*weight, *finalWeight);
-        if (device->needWeightAndBiasOnDevice())
-          finalWeight = finalWeight->toDevice(engine);
-        setCachedConstTensor(weightName, finalWeight);
-      }
+        conv->setSrc(srcAlloc->tensor);
+        conv->setDst(dstAlloc->tensor);
 
-      Ref<Tensor> finalBias = getCachedConstTensor(biasName, finalBiasDesc);
-      if (!finalBias)
+        Ref<Tensor> finalWeight, finalWeightScale, finalBias;
+        initInt8ConstTensors(name, {srcAlloc}, dstScale,
+                             finalWeightDesc, finalWeightScaleDesc, finalBiasDesc,
+                             finalWeight, finalWeightScale, finalBias);
+
+        conv->setWeight(finalWeight);
+        conv->setWeightScale(finalWeightScale);
+        conv->setBias(finalBias);
+      });
+
+      privateByteSize += finalWeightDesc.getByteSize() + finalWeightScaleDesc.getByteSize() +
+                         finalBiasDesc.getByteSize();
+      return conv;
+    }
+
+    // Adds the convolution to the graph, or a variant of it which passes the destination to output
+    // processing on the fly instead of storing it
+    auto addFloatConv = [=](const Ref<OutputProcess>& dstProcess)
+    {
+      Ref<Conv> finalConv = conv;
+      if (dstProcess)
       {
-        finalBias = makeRef<HostTensor>(finalBiasDesc);
-        reorderBias(*bias, *finalBias);
-        if (device->needWeightAndBiasOnDevice())
-          finalBias = finalBias->toDevice(engine);
-        setCachedConstTensor(biasName, finalBias);
+        ConvDesc finalConvDesc = convDesc;
+        finalConvDesc.processDst = true;
+        finalConv = engine->newConv(finalConvDesc);
+        finalConv->setName(name);
       }
 
-      conv->setWeight(finalWeight);
-      conv->setBias(finalBias);
-    });
+      // The convolution may require a different weight format
+      const TensorDesc finalWeightDesc = finalConv->getWeightDesc();
+      std::shared_ptr<TensorAlloc> dstAlloc;
+      if (dstProcess)
+        addOp(finalConv, {srcOp});
+      else
+        dstAlloc = addOp(finalConv, {srcOp}, finalConv->getDstDesc());
+
+      lazyInits.push_back([=]()
+      {
+        finalConv->setSrc(srcAlloc->tensor);
+        if (dstProcess)
+          finalConv->setDst(dstProcess);
+        else
+          finalConv->setDst(dstAlloc->tensor);
 
-    privateByteSize += finalWeightDesc.getByteSize() + finalBiasDesc.getByteSize();
+        Ref<Tensor> finalWeight = getCachedConstTensor(weightName, finalWeightDesc);
+        if (!finalWeight)
+        {
+          finalWeight = getFinalConstTensor(weightName, finalWeightDesc); // pre-reordered
+          if (!finalWeight)
+          {
+            finalWeight = makeRef<HostTensor>(finalWeightDesc);
+            reorderWeight(*weight, *finalWeight);
+          }
+          if (device->needWeightAndBiasOnDevice())
+            finalWeight = finalWeight->toDevice(engine);
+          setCachedConstTensor(weightName, finalWeight);
+        }
+
+        Ref<Tensor> finalBias = getCachedConstTensor(biasName, finalBiasDesc);
+        if (!finalBias)
+        {
+          finalBias = getFinalConstTensor(biasName, finalBiasDesc);
+          if (!finalBias)
+          {
+            finalBias = makeRef<HostTensor>(finalBiasDesc);
+            reorderBias(*bias, *finalBias);
+          }
+          if (device->needWeightAndBiasOnDevice())
+            finalBias = finalBias->toDevice(engine);
+          setCachedConstTensor(biasName, finalBias);
+        }
+
+        finalConv->setWeight(finalWeight);
+        finalConv->setBias(finalBias);
+      });
+
+      privateByteSize += finalWeightDesc.getByteSize() + finalBiasDesc.getByteSize();
+    };
+
+    // Defer adding the convolution until its output is used if the output processing could be
+    // fused into it (see addOutputProcess)
+    ConvDesc processDstConvDesc = convDesc;
+    processDstConvDesc.processDst = true;
+    if (engine->isConvSupported(processDstConvDesc))
+    {
+      if (deferredConv.op)
+        addDeferredConv(nullptr); // only the last convolution can be fused
+      deferredConv = {conv, addFloatConv};
+      dirty = true;
+      return conv;
+    }
+
+    addFloatConv(nullptr);
     return conv;
   }
 
@@ -159,9 +293,13 @@ OIDN_NAMESPACE_BEGIN
     Device* device = engine->getDevice();
     const int blockC = device->getTensorBlockC();
 
-    auto src1Alloc = tensorAllocs[src1Op.get()];
-    auto src2Alloc = tensorAllocs[src2Op.get()];
-    const TensorDesc src1Desc = src1Alloc->desc;
+    // The first source may be a deferred upsampling, which is not added to the graph if it can be
+    // fused into the convolution
+    auto src2Alloc = getSrcAlloc(src2Op);
+    auto upsample1It = deferredUpsamples.find(src1Op.get());
+    const bool isSrc1Upsampled = upsample1It != deferredUpsamples.end();
+    const TensorDesc src1Desc = isSrc1Upsampled ? upsample1It->second.op->getDstDesc()
+                                                : getSrcAlloc(src1Op)->desc;
     const TensorDesc src2Desc = src2Alloc->desc;
 
     TensorDims finalWeightDims{round_up(weight->getO(), blockC),
@@ -179,10 +317,28 @@ OIDN_NAMESPACE_BEGIN
                                 TensorLayout::x,
                                 device->getTensorDataType()};
 
-    ConcatConvDesc concatConvDesc{src1Desc, src2Desc, finalWeightDesc, finalBiasDesc, activation, fastMath};
+    const bool quantized = src1Desc.dataType == DataType::UInt8;
+    if ((src2Desc.dataType == DataType::UInt8) != quantized)
+      throw std::invalid_argument("mixed quantized and floating-point convolution sources");
+    const float dstScale = quantized ? getDstScale(name) : 0.f;
+    DataType dstDataType = src1Desc.dataType;
+    if (quantized)
+    {
+      finalWeightDesc.dataType = DataType::Int8;
+      finalBiasDesc.dataType = DataType::Float32;
+      dstDataType = (dstScale > 0.f) ? DataType::UInt8 : DataType::Float32;
+    }
+
+    ConcatConvDesc concatConvDesc{src1Desc, src2Desc, finalWeightDesc, finalBiasDesc, activation, fastMath,
+                                  batchSize, dstDataType, false};
 
     if (device->getTensorLayout() == TensorLayout::hwc)
     {
+      if (quantized)
+        throw std::invalid_argument("quantized concatenation and convolution is not supported");
+
+      auto src1Alloc = getSrcAlloc(src1Op);
+
       auto concatConv = makeRef<ConcatConvHWC>(engine, concatConvDesc);
       concatConv->setName(name);
       auto dstAlloc = addOp(concatConv, {src1Op, src2Op}, concatConv->getDstDesc());
@@ -220,8 +376,12 @@ OIDN_NAMESPACE_BEGIN
         Ref<Tensor> finalBias = getCachedConstTensor(biasName, finalBiasDesc);
         if (!finalBias)
         {
-          finalBias = makeRef<HostTensor>(finalBiasDesc);
-          reorderBias(*bias, *finalBias);
+          finalBias = getFinalConstTensor(biasName, finalBiasDesc);
+          if (!finalBias)
+          {
+            finalBias = makeRef<HostTensor>(finalBiasDesc);
+            reorderBias(*bias, *finalBias);
+          }
           if (device->needWeightAndBiasOnDevice())
             finalBias = finalBias->toDevice(engine);
           setCachedConstTensor(biasName, finalBias);
@@ -238,9 +398,48 @@ OIDN_NAMESPACE_BEGIN
     }
     else
     {
+      // Read the first source at half resolution if the upsampling can be fused
+      Ref<Op> src1StoredOp = src1Op;
+      if (isSrc1Upsampled && !quantized)
+      {
+        concatConvDesc.upsampleSrc1 = true;
+        if (ConcatConvCHW::isConvSupported(engine, concatConvDesc))
+          src1StoredOp = upsample1It->second.srcOp;
+        else
+          concatConvDesc.upsampleSrc1 = false;
+      }
+      auto src1Alloc = getSrcAlloc(src1StoredOp);
+
       auto concatConv = makeRef<ConcatConvCHW>(engine, concatConvDesc);
       concatConv->setName(name);
-      auto dstAlloc = addOp(concatConv, {src1Op, src2Op}, concatConv->getDstDesc(), true);
+      finalWeightDesc = concatConv->getWeightDesc();
+      auto dstAlloc = addOp(concatConv, {src1StoredOp, src2Op}, concatConv->getDstDesc(),
+                            concatConv->isSrcConcatRequired());
+      dstAlloc->scale = dstScale;
+
+      if (quantized)
+      {
+        const TensorDesc finalWeightScaleDesc = concatConv->getWeightScaleDesc();
+
+        lazyInits.push_back([=]()
+        {
+          concatConv->setSrc(src1Alloc->tensor, src2Alloc->tensor);
+          concatConv->setDst(dstAlloc->tensor);
+
+          Ref<Tensor> finalWeight, finalWeightScale, finalBias;
+          initInt8ConstTensors(name, {src1Alloc, src2Alloc}, dstScale,
+                               finalWeightDesc, finalWeightScaleDesc, finalBiasDesc,
+                               finalWeight, finalWeightScale, finalBias);
+
+          concatConv->setWeight(finalWeight);
+          concatConv->setWeightScale(finalWeightScale);
+          concatConv->setBias(finalBias);
+        });
+
+        privateByteSize += finalWeightDesc.getByteSize() + finalWeightScaleDesc.getByteSize() +
+                           finalBiasDesc.getByteSize();
+        return concatConv;
+      }
 
       lazyInits.push_back([=]()
       {
@@ -250,12 +449,18 @@ OIDN_NAMESPACE_BEGIN
         Ref<Tensor> finalWeight = getCachedConstTensor(weightName, finalWeightDesc);
         if (!finalWeight)
         {
-          finalWeight = makeRef<HostTensor>(finalWeightDesc);
+          // The weights can be pre-reordered only if the first source is not padded
+          if (src1Desc.getC() == src1Desc.getPaddedC())
+            finalWeight = getFinalConstTensor(weightName, finalWeightDesc);
+          if (!finalWeight)
+          {
+            finalWeight = makeRef<HostTensor>(finalWeightDesc);
 
-          reorderWeight(*weight, 0, src1Desc.getC(),
-                        *finalWeight, 0, src1Desc.getPaddedC());
-          reorderWeight(*weight, src1Desc.getC(), src2Desc.getC(),
-                        *finalWeight, src1Desc.getPaddedC(), src2Desc.getPaddedC());
+            reorderWeight(*weight, 0, src1Desc.getC(),
+                          *finalWeight, 0, src1Desc.getPaddedC());
+            reorderWeight(*weight, src1Desc.getC(), src2Desc.getC(),
+                          *finalWeight, src1Desc.getPaddedC(), src2Desc.getPaddedC());
+          }
 
           if (device->needWeightAndBiasOnDevice())
             finalWeight = finalWeight->toDevice(engine);
@@ -266,8 +471,12 @@ OIDN_NAMESPACE_BEGIN
         Ref<Tensor> finalBias = getCachedConstTensor(biasName, finalBiasDesc);
         if (!finalBias)
         {
-          finalBias = makeRef<HostTensor>(finalBiasDesc);
-          reorderBias(*bias, *finalBias);
+          finalBias = getFinalConstTensor(biasName, finalBiasDesc);
+          if (!finalBias)
+          {
+            finalBias = makeRef<HostTensor>(finalBiasDesc);
+            reorderBias(*bias, *finalBias);
+          }
           if (device->needWeightAndBiasOnDevice())
             finalBias = finalBias->toDevice(engine);
           setCachedConstTensor(biasName, finalBias);
@@ -285,10 +494,11 @@ OIDN_NAMESPACE_BEGIN
   Ref<Op> Graph::addPool(const std::string& name,
                          const Ref<Op>& srcOp)
   {
-    auto srcAlloc = tensorAllocs[srcOp.get()];
+    auto srcAlloc = getSrcAlloc(srcOp);
     auto op = engine->newPool({srcAlloc->desc});
     op->setName(name);
     auto dstAlloc = addOp(op, {srcOp}, op->getDstDesc());
+    dstAlloc->scale = srcAlloc->scale;
 
     lazyInits.push_back([=]()
     {
@@ -302,18 +512,47 @@ OIDN_NAMESPACE_BEGIN
   Ref<Op> Graph::addUpsample(const std::string& name,
                              const Ref<Op>& srcOp)
   {
-    auto srcAlloc = tensorAllocs[srcOp.get()];
+    auto srcAlloc = getSrcAlloc(srcOp);
     auto op = engine->newUpsample({srcAlloc->desc});
     op->setName(name);
+    addUpsample(op, srcOp);
+    return op;
+  }
+
+  void Graph::addDeferredConv(const Ref<OutputProcess>& dstProcess)
+  {
+    const DeferredConv conv = deferredConv;
+    deferredConv = {};
+    conv.add(dstProcess);
+  }
+
+  void Graph::addUpsample(const Ref<Upsample>& op, const Ref<Op>& srcOp)
+  {
+    auto srcAlloc = getSrcAlloc(srcOp);
     auto dstAlloc = addOp(op, {srcOp}, op->getDstDesc());
+    dstAlloc->scale = srcAlloc->scale;
 
     lazyInits.push_back([=]()
     {
       op->setSrc(srcAlloc->tensor);
       op->setDst(dstAlloc->tensor);
     });
+  }
 
-    return op;
+  std::shared_ptr<Graph::TensorAlloc> Graph::getSrcAlloc(const Ref<Op>& srcOp)
+  {
+    if (deferredConv.op && srcOp.get() == deferredConv.op.get())
+      addDeferredConv(nullptr);
+
+    auto upsampleIt = deferredUpsamples.find(srcOp.get());
+    if (upsampleIt != deferredUpsamples.end())
+    {
+      const DeferredUpsample upsample = upsampleIt->second;
+      deferredUpsamples.erase(upsampleIt);
+      addUpsample(upsample.op, upsample.srcOp);
+    }
+
+    return tensorAllocs[srcOp.get()];
   }
 
   void Graph::addOp(const Ref<Op>& op,
@@ -328,10 +567,17 @@ OIDN_NAMESPACE_BEGIN
     // Add the source tensor allocations as dependencies for the operation
     std::vector<int> srcAllocIDs;
     for (const auto& srcOp : srcOps)
-      srcAllocIDs.push_back(tensorAllocs[srcOp.get()]->id);
+    {
+      const int srcAllocID = tensorAllocs[srcOp.get()]->id;
+      srcAllocIDs.push_back(srcAllocID);
+      if (srcAllocID == inputAllocID)
+        inputLastOpID = opID;
+    }
     tensorScratchPlanner.addDepAllocs(opID, srcAllocIDs, concatSrcs);
 
+    chained.push_back(srcOps.size() == 1 && !ops.empty() && srcOps[0] == ops.back());
     ops.push_back(op);
+    outputFused = false;
     workAmount += op->getWorkAmount();
     dirty = true;
   }
@@ -357,6 +603,36 @@ OIDN_NAMESPACE_BEGIN
 
   void Graph::planAllocs()
   {
+    // The last convolution may be still deferred if its output is not used by any op
+    if (deferredConv.op)
+      addDeferredConv(nullptr);
+
+    // For pipelined submission, the input and output processing run concurrently with the other ops,
+    // so their tensors must not share memory with any other tensor. If the output processing is
+    // fused into the last op, only the input processing runs concurrently
+    if (pipelined)
+    {
+      if (outputFused)
+      {
+        if (inputAllocID < 0 || ops.size() - 1 <= inputLastOpID)
+          throw std::logic_error("graph does not support pipelined submission");
+        if (ops.front()->getScratchByteSize() > 0)
+          throw std::logic_error("concurrent input processing cannot use scratch memory");
+      }
+      else
+      {
+        if (inputAllocID < 0 || outputSrcAllocID < 0 || outputSrcOpID != ops.size() - 2 ||
+            outputSrcOpID <= inputLastOpID)
+          throw std::logic_error("graph does not support pipelined submission");
+        if (ops.front()->getScratchByteSize() > 0 || ops.back()->getScratchByteSize() > 0)
+          throw std::logic_error("concurrent input/output processing cannot use scratch memory");
+
+        tensorScratchPlanner.setAllocPersistent(outputSrcAllocID);
+      }
+
+      tensorScratchPlanner.setAllocPersistent(inputAllocID);
+    }
+
     tensorScratchPlanner.commit();
 
     // Compute the size of the operation scratch
@@ -406,7 +682,11 @@ OIDN_NAMESPACE_BEGIN
   {
     lazyInits.clear();
     tensorAllocs.clear();
+    deferredUpsamples.clear();
+    deferredConv = {};
     tensorScratchPlanner.clear();
+    inputAllocID = -1;
+    outputSrcAllocID = -1;
   }
 
   void Graph::clear()
@@ -416,14 +696,31 @@ OIDN_NAMESPACE_BEGIN
 
     cleanup();
     ops.clear();
+    chained.clear();
     scratch.reset();
     scratchByteSize = 0;
     privateByteSize = 0;
     workAmount = 0;
+    batchSize = 1;
+    outputFused = false;
     tensorScratchByteOffset = 0;
+    pipelined = false;
+    inputLastOpID = 0;
+    outputSrcOpID = 0;
     dirty = false;
   }
 
+  void Graph::setPipelined(bool pipelined)
+  {
+    if (finalized)
+      throw std::logic_error("graph cannot be changed after finalization");
+    if (pipelined && !engine->isConcurrencySupported())
+      throw std::logic_error("pipelined submission is not supported by the engine");
+
+    this->pipelined = pipelined;
+    dirty = true;
+  }
+
   void Graph::finalize()
   {
     if (dirty)
@@ -465,6 +762,15 @@ OIDN_NAMESPACE_BEGIN
 
     for (size_t i = 0; i < ops.size(); ++i)
     {
+    #if !defined(OIDN_MICROBENCH)
+      const size_t chainSize = submitChain(i, ops.size(), progress);
+      if (chainSize > 0)
+      {
+        i += chainSize - 1;
+        continue;
+      }
+    #endif
+
       ops[i]->submit(progress);
 
     #if defined(OIDN_MICROBENCH)
@@ -525,11 +831,215 @@ OIDN_NAMESPACE_BEGIN
   #endif
   }
 
+  void Graph::submitWithoutOutput(const Ref<Progress>& progress)
+  {
+    if (!finalized)
+      throw std::logic_error("graph not finalized");
+    if (ops.empty() || (!dynamicRefCast<OutputProcess>(ops.back()) && !outputFused))
+      throw std::logic_error("graph does not end with output processing");
+
+    submitOps(0, ops.size() - 1, progress);
+  }
+
+  void Graph::checkPipelined() const
+  {
+    if (!finalized)
+      throw std::logic_error("graph not finalized");
+    if (!pipelined)
+      throw std::logic_error("graph is not pipelined");
+  }
+
+  // Submits the chain of ops starting at the specified op depth-first if supported by the engine,
+  // and returns the number of submitted ops
+  size_t Graph::submitChain(size_t begin, size_t end, const Ref<Progress>& progress)
+  {
+    size_t chainEnd = begin + 1;
+    while (chainEnd < end && chained[chainEnd])
+      ++chainEnd;
+
+    if (chainEnd - begin < 2)
+      return 0;
+    return engine->submitDepthFirst(ops, begin, chainEnd, progress);
+  }
+
+  void Graph::submitOps(size_t begin, size_t end, const Ref<Progress>& progress)
+  {
+    for (size_t i = begin; i < end; )
+    {
+      const size_t chainSize = submitChain(i, end, progress);
+      if (chainSize > 0)
+      {
+        i += chainSize;
+        continue;
+      }
+
+      ops[i]->submit(progress);
+      ++i;
+    }
+  }
+
+  void Graph::submitConcurrent(const Ref<Op>& op, const Ref<Progress>& progress)
+  {
+    engine->beginConcurrent();
+    try
+    {
+      op->submit(progress);
+    }
+    catch (...)
+    {
+      engine->endConcurrent();
+      throw;
+    }
+    engine->endConcurrent();
+  }
+
+  void Graph::submitInput(const Ref<Progress>& progress)
+  {
+    checkPipelined();
+    submitConcurrent(ops.front(), progress);
+    inputPending = true;
+  }
+
+  void Graph::submitHead(const Ref<Progress>& progress)
+  {
+    checkPipelined();
+
+    // The input tensor must be ready
+    if (inputPending)
+      submitJoin();
+
+    submitOps(1, inputLastOpID + 1, progress);
+  }
+
+  void Graph::submitTail(const Ref<Progress>& progress)
+  {
+    checkPipelined();
+
+    // The fused output processing writes directly to the output, so it is part of the tail
+    if (outputFused)
+    {
+      submitOps(inputLastOpID + 1, ops.size(), progress);
+      return;
+    }
+
+    submitOps(inputLastOpID + 1, outputSrcOpID, progress);
+
+    // The output tensor of the previous tile must be processed before overwriting it
+    if (outputPending)
+      submitJoin();
+
+    submitOps(outputSrcOpID, ops.size() - 1, progress);
+  }
+
+  void Graph::submitOutput(const Ref<Progress>& progress)
+  {
+    checkPipelined();
+    if (outputFused)
+      return; // already submitted by submitTail
+
+    submitConcurrent(ops.back(), progress);
+    outputPending = true;
+  }
+
+  void Graph::submitJoin()
+  {
+    engine->submitJoin();
+    inputPending  = false;
+    outputPending = false;
+  }
+
+  // Returns the quantization scale of the destination of a convolution, or 0 if it is unknown
+  float Graph::getDstScale(const std::string& name) const
+  {
+    auto scaleIter = constTensors->find(name + ".dst_scale");
+    if (scaleIter == constTensors->end())
+      return 0.f;
+
+    const Ref<Tensor>& scale = scaleIter->second;
+    if (scale->getRank() != 1 || scale->getX() != 1 || scale->getDataType() != DataType::Float32)
+      throw std::invalid_argument("invalid convolution destination scale");
+
+    TensorAccessor1D<float> scaleAcc = *scale;
+    if (!(scaleAcc(0) > 0.f))
+      throw std::invalid_argument("invalid convolution destination scale");
+    return scaleAcc(0);
+  }
+
+  // Quantizes the weights of a convolution with the specified sources and initializes the
+  // corresponding bias
+  void Graph::initInt8ConstTensors(const std::string& name,
+                                   const std::vector<std::shared_ptr<TensorAlloc>>& srcAllocs,
+                                   float dstScale,
+                                   const TensorDesc& weightDesc,
+                                   const TensorDesc& weightScaleDesc,
+                                   const TensorDesc& biasDesc,
+                                   Ref<Tensor>& finalWeight,
+                                   Ref<Tensor>& finalWeightScale,
+                                   Ref<Tensor>& finalBias)
+  {
+    // The quantized tensors must not be mixed up with floating-point ones of the same shape
+    const std::string weightName      = name + ".weight.int8";
+    const std::string weightScaleName = name + ".weight_scale.int8";
+    const std::string biasName        = name + ".bias.int8";
+
+    finalWeight      = getCachedConstTensor(weightName, weightDesc);
+    finalWeightScale = getCachedConstTensor(weightScaleName, weightScaleDesc);
+    finalBias        = getCachedConstTensor(biasName, biasDesc);
+    if (finalWeight && finalWeightScale && finalBias)
+      return;
+
+    Device* device = engine->getDevice();
+    Ref<Tensor> weight = (*constTensors)[name + ".weight"];
+    Ref<Tensor> bias   = (*constTensors)[name + ".bias"];
+
+    // Reorder the weights to floating-point first, keeping track of the scale of each input channel
+    auto floatWeight = makeRef<HostTensor>(TensorDesc{weightDesc.dims, weightDesc.paddedDims,
+                                                      device->getWeightLayout(), DataType::Float32});
+    std::vector<float> srcScales;
+    int srcBeginI = 0;
+    for (const auto& srcAlloc : srcAllocs)
+    {
+      reorderWeight(*weight, srcBeginI, srcAlloc->desc.getC(),
+                    *floatWeight, int(srcScales.size()), srcAlloc->desc.getPaddedC());
+      srcBeginI += srcAlloc->desc.getC();
+      srcScales.insert(srcScales.end(), srcAlloc->desc.getPaddedC(), srcAlloc->scale);
+    }
+
+    finalWeight      = makeRef<HostTensor>(weightDesc);
+    finalWeightScale = makeRef<HostTensor>(weightScaleDesc);
+    quantizeWeight(*floatWeight, srcScales, dstScale, *finalWeight, *finalWeightScale);
+
+    // The bias must be in the scale of the destination
+    finalBias = makeRef<HostTensor>(biasDesc);
+    reorderBias(*bias, *finalBias, (dstScale > 0.f) ? (1.f / dstScale) : 1.f);
+
+    if (device->needWeightAndBiasOnDevice())
+    {
+      finalWeight      = finalWeight->toDevice(engine);
+      finalWeightScale = finalWeightScale->toDevice(engine);
+      finalBias        = finalBias->toDevice(engine);
+    }
+
+    setCachedConstTensor(weightName, finalWeight);
+    setCachedConstTensor(weightScaleName, finalWeightScale);
+    setCachedConstTensor(biasName, finalBias);
+  }
+
+  Ref<Tensor> Graph::getFinalConstTensor(const std::string& name, const TensorDesc& finalDesc)
+  {
+    auto tensorIter = constTensors->find(getTZAVariantName(name, finalDesc.layout, finalDesc.dataType));
+    if (tensorIter != constTensors->end() && tensorIter->second->getDesc() == finalDesc)
+      return tensorIter->second;
+    return nullptr;
+  }
+
   Ref<Tensor> Graph::getCachedConstTensor(const std::string& name, const TensorDesc& desc)
   {
     if (cachedConstTensors)
     {
-      auto tensorIter = cachedConstTensors->find(name);
+      // The same weights may be cached in multiple layouts and data types (e.g. for different
+      // precisions)
+      auto tensorIter = cachedConstTensors->find(getTZAVariantName(name, desc.layout, desc.dataType));
       if (tensorIter != cachedConstTensors->end() && tensorIter->second->getDesc() == desc)
         return tensorIter->second;
     }
@@ -539,8 +1049,19 @@ OIDN_NAMESPACE_BEGIN
 
   void Graph::setCachedConstTensor(const std::string& name, const Ref<Tensor>& tensor)
   {
-    if (cachedConstTensors)
-      (*cachedConstTensors)[name] = tensor;
+    if (!cachedConstTensors)
+      return;
+
+    const TensorDesc& desc = tensor->getDesc();
+    const std::string variantName = getTZAVariantName(name, desc.layout, desc.dataType);
+
+    // Pre-reordered tensors used in-place must not be cached because they reference the memory of
+    // the weights, which may be released before the cache entry (e.g. user weights)
+    auto tensorIter = constTensors->find(variantName);
+    if (tensorIter != constTensors->end() && tensorIter->second == tensor)
+      return;
+
+    (*cachedConstTensors)[variantName] = tensor;
   }
 
 OIDN_NAMESPACE_END
@@ -20,12 +20,15 @@ OIDN_NAMESPACE_BEGIN
     Graph(Engine* engine,
           const std::shared_ptr<TensorMap>& constTensors,
           const std::shared_ptr<TensorMap>& cachedConstTensors,
-          bool fastMath = false);
+          bool fastMath = false,
+          Precision precision = Precision::Default);
 
     Engine* getEngine() const override { return engine; }
 
+    // The source dimensions are those of a single image in the batch
     Ref<InputProcess> addInputProcess(const std::string& name,
                                       const TensorDims& srcDims,
+                                      int batchSize,
                                       const std::shared_ptr<TransferFunction>& transferFunc,
                                       bool hdr,
                                       bool snorm);
@@ -63,12 +66,35 @@ OIDN_NAMESPACE_BEGIN
     void finalize() override;
     void submit(const Ref<Progress>& progress) override;
 
+    // Submits all ops except the final output processing, leaving the output image untouched
+    // (e.g. for measuring the performance of the graph). If the output processing is fused into
+    // the last op, that op is skipped too
+    void submitWithoutOutput(const Ref<Progress>& progress);
+
+    // Enables pipelined submission of consecutive tiles, which requires the engine to support
+    // concurrency and the graph to start with input processing and end with output processing.
+    // The input and output tensors are kept alive during the whole graph, so the input processing
+    // of the next tile and the output processing of the previous tile can run concurrently with
+    // the other ops of the current tile. If the output processing is fused into the last op, it is
+    // submitted by submitTail instead. A tile is submitted in the following order:
+    //   submitInput, [submitTail and submitOutput of the previous tile], submitHead
+    // After the last tile, submitTail, submitOutput and submitJoin must be called
+    void setPipelined(bool pipelined);
+    bool isPipelined() const { return pipelined; }
+
+    void submitInput(const Ref<Progress>& progress);  // input processing (concurrent)
+    void submitHead(const Ref<Progress>& progress);   // ops up to the last one using the input
+    void submitTail(const Ref<Progress>& progress);   // remaining ops except unfused output processing
+    void submitOutput(const Ref<Progress>& progress); // unfused output processing (concurrent)
+    void submitJoin();                                // waits for concurrent processing
+
   private:
     // Temporary tensor allocation
     struct TensorAlloc
     {
-      TensorDesc desc; // tensor descriptor
-      int id;          // allocation ID used by the scratch planner
+      TensorDesc desc;   // tensor descriptor
+      int id;            // allocation ID used by the scratch planner
+      float scale = 1.f; // quantization scale (only for UInt8 tensors)
 
       // Set only when planning allocations
       Ref<Tensor> tensor;
@@ -81,6 +107,13 @@ OIDN_NAMESPACE_BEGIN
     void addOp(const Ref<Op>& op, const std::vector<Ref<Op>>& srcOps,
                bool concatSrcs = false);
 
+    void addDeferredConv(const Ref<OutputProcess>& dstProcess);
+    void addUpsample(const Ref<Upsample>& op, const Ref<Op>& srcOp);
+
+    // Returns the allocation of the output of an op used as a source, adding the op first if it
+    // is a deferred convolution or upsampling
+    std::shared_ptr<TensorAlloc> getSrcAlloc(const Ref<Op>& srcOp);
+
     std::shared_ptr<TensorAlloc> addOp(const Ref<Op>& op,
                                        const std::vector<Ref<Op>>& srcOps,
                                        const TensorDesc& dstDesc,
@@ -88,27 +121,77 @@ OIDN_NAMESPACE_BEGIN
 
     void planAllocs();
     void cleanup();
-
+    void checkPipelined() const;
+    size_t submitChain(size_t begin, size_t end, const Ref<Progress>& progress);
+    void submitOps(size_t begin, size_t end, const Ref<Progress>& progress);
+    void submitConcurrent(const Ref<Op>& op, const Ref<Progress>& progress);
+
+    float getDstScale(const std::string& name) const;
+    void initInt8ConstTensors(const std::string& name,
+                              const std::vector<std::shared_ptr<TensorAlloc>>& srcAllocs,
+                              float dstScale,
+                              const TensorDesc& weightDesc,
+                              const TensorDesc& weightScaleDesc,
+                              const TensorDesc& biasDesc,
+                              Ref<Tensor>& finalWeight,
+                              Ref<Tensor>& finalWeightScale,
+                              Ref<Tensor>& finalBias);
+
+    // Returns the variant of a constant tensor which is already stored in the final format (e.g.
+    // pre-reordered weights), which can be used without reordering, or null if there is none
+    Ref<Tensor> getFinalConstTensor(const std::string& name, const TensorDesc& finalDesc);
     Ref<Tensor> getCachedConstTensor(const std::string& name, const TensorDesc& desc);
     void setCachedConstTensor(const std::string& name, const Ref<Tensor>& tensor);
 
     Engine* engine;
     std::vector<Ref<Op>> ops;
+    std::vector<bool> chained; // whether each op consumes only the output of the previous op
     Ref<Buffer> scratch;        // scratch buffer
     size_t scratchByteSize = 0; // total size of scratch data
     size_t privateByteSize = 0; // total size of private data (e.g. constant tensors)
     size_t workAmount = 0;      // total estimated amount of work for progress monitoring
+    int batchSize = 1;          // number of images stacked in the H dimension of the tensors
     bool dirty = false;
     bool finalized = false;
+    bool outputFused = false;   // the output processing is fused into the last op
+
+    // Pipelined submission
+    bool pipelined = false;
+    size_t inputLastOpID = 0;   // index of the last op using the output of the input processing
+    size_t outputSrcOpID = 0;   // index of the op producing the source of the output processing
+    bool inputPending  = false; // concurrent input processing has not been joined yet
+    bool outputPending = false; // concurrent output processing has not been joined yet
 
     // Used only while building the graph
     ArenaPlanner tensorScratchPlanner;  // tensor scratch allocation planner
     size_t tensorScratchByteOffset = 0; // offset of tensor data in the scratch buffer
+    int inputAllocID = -1;              // allocation ID of the output of the input processing
+    int outputSrcAllocID = -1;          // allocation ID of the source of the output processing
     std::unordered_map<Op*, std::shared_ptr<TensorAlloc>> tensorAllocs;
+
+    // Upsamplings split from convolutions are added to the graph only when their output is used,
+    // so they can be fused into the consuming op instead if supported (see addConcatConv)
+    struct DeferredUpsample
+    {
+      Ref<Upsample> op;
+      Ref<Op> srcOp;
+    };
+    std::unordered_map<Op*, DeferredUpsample> deferredUpsamples;
+
+    // The last floating-point convolution is also deferred if the engine supports fusing the
+    // output processing into it, which requires creating a different op (see addOutputProcess)
+    struct DeferredConv
+    {
+      Ref<Conv> op; // the convolution without fused output processing
+      std::function<void(const Ref<OutputProcess>& dstProcess)> add;
+    };
+    DeferredConv deferredConv;
+
     std::vector<std::function<void()>> lazyInits;  // lazy initialization for ops
     std::shared_ptr<TensorMap> constTensors;       // original weights
     std::shared_ptr<TensorMap> cachedConstTensors; // cached final weights shared with other graphs
     bool fastMath = false;
+    Precision precision = Precision::Default; // precision of the tensors
   };
 
 OIDN_NAMESPACE_END
@@ -103,4 +103,19 @@ OIDN_NAMESPACE_BEGIN
     return begin1 < end2 && begin2 < end1;
   }
 
+  Ref<Image> Image::getRows(int hBegin, int H)
+  {
+    if (hBegin < 0 || H < 0 || hBegin + H > getH())
+      throw std::out_of_range("image rows out of bounds");
+
+    const size_t rowsByteOffset = size_t(hBegin) * hByteStride;
+
+    if (buffer)
+      return makeRef<Image>(buffer, format, width, H, byteOffset + rowsByteOffset,
+                            wByteStride, hByteStride);
+    else
+      return makeRef<Image>(ptr, format, width, H, rowsByteOffset,
+                            wByteStride, hByteStride);
+  }
+
 OIDN_NAMESPACE_END
\ No newline at end of file
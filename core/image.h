@@ -115,6 +115,9 @@ OIDN_NAMESPACE_BEGIN
     // Determines whether two images overlap in memory
     bool overlaps(const Image& other) const;
 
+    // Returns an image referencing a range of rows of this image
+    Ref<Image> getRows(int hBegin, int H);
+
   private:
     char* ptr; // pointer to the first pixel
   };
@@ -14,6 +14,13 @@ OIDN_NAMESPACE_BEGIN
     void setSrc(const Ref<Image>& src) { this->src = src; }
     void setDst(const Ref<Image>& dst) { this->dst = dst; }
 
+    bool getAccesses(std::vector<MemoryAccess>& accesses) const override
+    {
+      addAccess(accesses, src, false);
+      addAccess(accesses, dst, true);
+      return true;
+    }
+
   protected:
     void check()
     {
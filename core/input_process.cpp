@@ -9,10 +9,10 @@ OIDN_NAMESPACE_BEGIN
   InputProcess::InputProcess(Engine* engine, const InputProcessDesc& desc)
     : InputProcessDesc(desc)
   {
-    if (srcDims.size() != 3)
+    if (srcDims.size() != 3 || batchSize < 1)
       throw std::invalid_argument("invalid input processing source shape");
 
-    TensorDims dstDims = srcDims;
+    TensorDims dstDims{srcDims[0], srcDims[1] * batchSize, srcDims[2]};
 
     TensorDims dstPaddedDims {
       round_up(srcDims[0], engine->getDevice()->getTensorBlockC()), // round up C
@@ -20,7 +20,7 @@ OIDN_NAMESPACE_BEGIN
       dstDims[2]
     };
 
-    dstDesc = {dstDims, dstPaddedDims, engine->getDevice()->getTensorLayout(), engine->getDevice()->getTensorDataType()};
+    dstDesc = {dstDims, dstPaddedDims, engine->getDevice()->getTensorLayout(), dstDataType};
 
     setTile(0, 0, 0, 0, 0, 0);
   }
@@ -60,13 +60,33 @@ OIDN_NAMESPACE_BEGIN
     tile.W = W;
   }
 
+  void InputProcess::setBatch(int count, int hSrcStride)
+  {
+    if (count < 1 || count > batchSize)
+      throw std::invalid_argument("invalid input processing batch");
+
+    batchCount = count;
+    hSrcBatchStride = hSrcStride;
+  }
+
+  bool InputProcess::getAccesses(std::vector<MemoryAccess>& accesses) const
+  {
+    addAccess(accesses, color, false);
+    addAccess(accesses, albedo, false);
+    addAccess(accesses, normal, false);
+    if (transferFunc->inputScalePtr) // computed by autoexposure
+      addAccess(accesses, transferFunc->inputScalePtr, sizeof(float), false);
+    addAccess(accesses, dst, true);
+    return true;
+  }
+
   void InputProcess::check()
   {
     if (!getMainSrc() || !dst)
       throw std::logic_error("input processing source/destination not set");
-    if (tile.hSrcBegin + tile.H > getMainSrc()->getH() ||
+    if (tile.hSrcBegin + (batchCount-1) * hSrcBatchStride + tile.H > getMainSrc()->getH() ||
         tile.wSrcBegin + tile.W > getMainSrc()->getW() ||
-        tile.hDstBegin + tile.H > dst->getH() ||
+        tile.hDstBegin + tile.H > dst->getH() / batchSize ||
         tile.wDstBegin + tile.W > dst->getW())
       throw std::out_of_range("input processing source/destination out of bounds");
   }
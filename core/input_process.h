@@ -13,10 +13,12 @@ OIDN_NAMESPACE_BEGIN
 
   struct InputProcessDesc
   {
-    TensorDims srcDims;
+    TensorDims srcDims; // dimensions of a single image in the batch
+    int batchSize;      // number of images stacked in the H dimension of the destination
     std::shared_ptr<TransferFunction> transferFunc;
     bool hdr;
     bool snorm;
+    DataType dstDataType; // UInt8 destinations are quantized with a scale of 1/255
   };
 
   class InputProcess : public BaseOp, protected InputProcessDesc
@@ -33,6 +35,12 @@ OIDN_NAMESPACE_BEGIN
     void setDst(const Ref<Tensor>& dst);
     void setTile(int hSrc, int wSrc, int hDst, int wDst, int H, int W);
 
+    // Sets the number of images to process in the batch and the row stride between them in the
+    // source (the tile is at the same position in all images)
+    void setBatch(int count, int hSrcStride);
+
+    bool getAccesses(std::vector<MemoryAccess>& accesses) const override;
+
   protected:
     virtual void updateSrc() {}
     void check();
@@ -48,6 +56,8 @@ OIDN_NAMESPACE_BEGIN
     Ref<Image> normal;
     Ref<Tensor> dst;
     Tile tile;
+    int batchCount = 1;      // number of images to process in the batch
+    int hSrcBatchStride = 0; // row stride between the images in the source
   };
 
 OIDN_NAMESPACE_END
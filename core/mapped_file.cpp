@@ -0,0 +1,80 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "mapped_file.h"
+
+#if !defined(_WIN32)
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+OIDN_NAMESPACE_BEGIN
+
+  MappedFile::MappedFile(const std::string& filename)
+    : filename(filename)
+  {
+    const std::string errorMessage = "could not map file: '" + filename + "'";
+
+  #if defined(_WIN32)
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      throw Exception(Error::InvalidArgument, errorMessage);
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+      CloseHandle(file);
+      throw Exception(Error::InvalidArgument, errorMessage);
+    }
+    byteSize = size_t(fileSize.QuadPart);
+
+    // The mapping keeps the file open
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+      throw Exception(Error::InvalidArgument, errorMessage);
+
+    ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (ptr == nullptr)
+    {
+      CloseHandle(mapping);
+      throw Exception(Error::InvalidArgument, errorMessage);
+    }
+  #else
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw Exception(Error::InvalidArgument, errorMessage);
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+      close(fd);
+      throw Exception(Error::InvalidArgument, errorMessage);
+    }
+    byteSize = size_t(fileStat.st_size);
+
+    // The mapping remains valid after closing the file
+    ptr = mmap(nullptr, byteSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED)
+    {
+      ptr = nullptr;
+      throw Exception(Error::InvalidArgument, errorMessage);
+    }
+  #endif
+  }
+
+  MappedFile::~MappedFile()
+  {
+  #if defined(_WIN32)
+    UnmapViewOfFile(ptr);
+    CloseHandle(mapping);
+  #else
+    munmap(ptr, byteSize);
+  #endif
+  }
+
+OIDN_NAMESPACE_END
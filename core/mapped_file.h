@@ -0,0 +1,35 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "exception.h"
+#include "data.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  // Read-only memory-mapped file
+  // The pages of the file are loaded on demand and shared with other processes mapping the same file
+  class MappedFile final
+  {
+  public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    const std::string& getFilename() const { return filename; }
+    Data getData() const { return Data(ptr, byteSize); }
+
+  private:
+    // Disable copying
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator =(const MappedFile&) = delete;
+
+    std::string filename;
+    void* ptr = nullptr;
+    size_t byteSize = 0;
+  #if defined(_WIN32)
+    HANDLE mapping = nullptr;
+  #endif
+  };
+
+OIDN_NAMESPACE_END
@@ -2,23 +2,65 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "op.h"
+#include "tensor.h"
 
 OIDN_NAMESPACE_BEGIN
 
+  void Op::addAccess(std::vector<MemoryAccess>& accesses,
+                     const void* ptr, size_t byteSize, bool write)
+  {
+    if (ptr && byteSize > 0)
+      accesses.push_back({ptr, static_cast<const char*>(ptr) + byteSize, write});
+  }
+
+  void Op::addAccess(std::vector<MemoryAccess>& accesses, const Ref<Buffer>& buffer, bool write)
+  {
+    if (buffer)
+      addAccess(accesses, buffer->getPtr(), buffer->getByteSize(), write);
+  }
+
+  void Op::addAccess(std::vector<MemoryAccess>& accesses, const Ref<Tensor>& tensor, bool write)
+  {
+    if (tensor)
+      addAccess(accesses, tensor->getPtr(), tensor->getByteSize(), write);
+  }
+
+  void Op::addAccess(std::vector<MemoryAccess>& accesses, const Ref<Image>& image, bool write)
+  {
+    if (image)
+      addAccess(accesses, image->getPtr(), image->getByteSize(), write);
+  }
+
   void BaseOp::submit(const Ref<Progress>& progress)
   {
-    Engine* engine = nullptr;
+    Engine* engine = getEngine();
 
-    if (progress)
+    // Declare the accessed memory for the kernels and the progress updates as well, so the
+    // updates are ordered with respect to the kernels
+    std::vector<MemoryAccess> accesses;
+    const bool trackAccesses = engine->isDependencyTrackingSupported() && getAccesses(accesses);
+    if (trackAccesses)
+      engine->beginAccesses(accesses);
+
+    try
     {
-      engine = getEngine();
-      Progress::submitUpdate(engine, progress);
-    }
+      if (progress)
+        Progress::submitUpdate(engine, progress);
 
-    submitKernels(progress);
+      submitKernels(progress);
+
+      if (progress)
+        Progress::submitUpdate(engine, progress, getWorkAmount());
+    }
+    catch (...)
+    {
+      if (trackAccesses)
+        engine->endAccesses();
+      throw;
+    }
 
-    if (progress)
-      Progress::submitUpdate(engine, progress, getWorkAmount());
+    if (trackAccesses)
+      engine->endAccesses();
   }
 
 OIDN_NAMESPACE_END
\ No newline at end of file
@@ -32,10 +32,21 @@ OIDN_NAMESPACE_BEGIN
     // Returns the estimated amount of work for progress monitoring
     virtual size_t getWorkAmount() const { return 1; }
 
+    // Gets the memory ranges read and written by the operation for dependency tracking
+    // Returns false if the accesses are unknown, in which case the operation is executed in order
+    virtual bool getAccesses(std::vector<MemoryAccess>& accesses) const { return false; }
+
     // Name for debugging purposes
     std::string getName() const { return name; }
     void setName(const std::string& name) { this->name = name; }
 
+  protected:
+    static void addAccess(std::vector<MemoryAccess>& accesses,
+                          const void* ptr, size_t byteSize, bool write);
+    static void addAccess(std::vector<MemoryAccess>& accesses, const Ref<Buffer>& buffer, bool write);
+    static void addAccess(std::vector<MemoryAccess>& accesses, const Ref<Tensor>& tensor, bool write);
+    static void addAccess(std::vector<MemoryAccess>& accesses, const Ref<Image>& image, bool write);
+
   private:
     std::string name;
   };
@@ -8,7 +8,7 @@ OIDN_NAMESPACE_BEGIN
   OutputProcess::OutputProcess(const OutputProcessDesc& desc)
     : OutputProcessDesc(desc)
   {
-    if (srcDesc.getRank() != 3)
+    if (srcDesc.getRank() != 3 || batchSize < 1 || srcDesc.getH() % batchSize != 0)
       throw std::invalid_argument("invalid output processing source shape");
 
     setTile(0, 0, 0, 0, 0, 0);
@@ -40,15 +40,45 @@ OIDN_NAMESPACE_BEGIN
     tile.W = W;
   }
 
-  void OutputProcess::check()
+  void OutputProcess::setBatch(int count, int hDstStride)
+  {
+    if (count < 1 || count > batchSize)
+      throw std::invalid_argument("invalid output processing batch");
+
+    batchCount = count;
+    hDstBatchStride = hDstStride;
+  }
+
+  bool OutputProcess::getAccesses(std::vector<MemoryAccess>& accesses) const
+  {
+    addAccess(accesses, src, false);
+    getDstAccesses(accesses);
+    return true;
+  }
+
+  void OutputProcess::getDstAccesses(std::vector<MemoryAccess>& accesses) const
   {
-    if (!src || !dst)
-      throw std::logic_error("output processing source/destination not set");
-    if (tile.hSrcBegin + tile.H > src->getH() ||
-        tile.wSrcBegin + tile.W > src->getW() ||
-        tile.hDstBegin + tile.H > dst->getH() ||
+    if (transferFunc->inputScalePtr) // computed by autoexposure
+      addAccess(accesses, transferFunc->inputScalePtr, sizeof(float), false);
+    addAccess(accesses, dst, true);
+  }
+
+  void OutputProcess::checkDst()
+  {
+    if (!dst)
+      throw std::logic_error("output processing destination not set");
+    if (tile.hSrcBegin + tile.H > srcDesc.getH() / batchSize ||
+        tile.wSrcBegin + tile.W > srcDesc.getW() ||
+        tile.hDstBegin + (batchCount-1) * hDstBatchStride + tile.H > dst->getH() ||
         tile.wDstBegin + tile.W > dst->getW())
       throw std::out_of_range("output processing source/destination out of bounds");
   }
 
+  void OutputProcess::check()
+  {
+    if (!src)
+      throw std::logic_error("output processing source not set");
+    checkDst();
+  }
+
 OIDN_NAMESPACE_END
\ No newline at end of file
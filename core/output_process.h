@@ -14,6 +14,7 @@ OIDN_NAMESPACE_BEGIN
   struct OutputProcessDesc
   {
     TensorDesc srcDesc;
+    int batchSize; // number of images stacked in the H dimension of the source
     std::shared_ptr<TransferFunction> transferFunc;
     bool hdr;
     bool snorm;
@@ -31,12 +32,24 @@ OIDN_NAMESPACE_BEGIN
     void setDst(const Ref<Image>& dst);
     void setTile(int hSrc, int wSrc, int hDst, int wDst, int H, int W);
 
+    // Sets the number of images to process in the batch and the row stride between them in the
+    // destination (the tile is at the same position in all images)
+    void setBatch(int count, int hDstStride);
+
+    bool getAccesses(std::vector<MemoryAccess>& accesses) const override;
+
+    // Adds only the accesses to the destination, for ops which compute the source on the fly
+    void getDstAccesses(std::vector<MemoryAccess>& accesses) const;
+
   protected:
+    void checkDst(); // checks only the destination and the tile (without a source)
     void check();
 
     Ref<Tensor> src;
     Ref<Image> dst;
     Tile tile;
+    int batchCount = 1;      // number of images to process in the batch
+    int hDstBatchStride = 0; // row stride between the images in the destination
   };
 
 OIDN_NAMESPACE_END
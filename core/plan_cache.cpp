@@ -0,0 +1,81 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "plan_cache.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  bool PlanKey::operator ==(const PlanKey& other) const
+  {
+    return weightsHash == other.weightsHash && weightsByteSize == other.weightsByteSize &&
+           H == other.H && W == other.W && batchSize == other.batchSize &&
+           colorFormat  == other.colorFormat  && albedoFormat == other.albedoFormat &&
+           normalFormat == other.normalFormat && outputFormat == other.outputFormat &&
+           quality == other.quality && precision == other.precision &&
+           maxMemoryMB == other.maxMemoryMB && hdr == other.hdr && inplace == other.inplace &&
+           autotune == other.autotune && skipConstantTiles == other.skipConstantTiles;
+  }
+
+  size_t PlanKey::getHash() const
+  {
+    size_t hash = std::hash<uint64_t>()(weightsHash);
+    auto combine = [&](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+
+    combine(weightsByteSize);
+    combine(size_t(H));
+    combine(size_t(W));
+    combine(size_t(batchSize));
+    combine(size_t(colorFormat));
+    combine(size_t(albedoFormat));
+    combine(size_t(normalFormat));
+    combine(size_t(outputFormat));
+    combine(size_t(quality));
+    combine(size_t(precision));
+    combine(size_t(maxMemoryMB));
+    combine(size_t(hdr) | (size_t(inplace) << 1) | (size_t(autotune) << 2) |
+            (size_t(skipConstantTiles) << 3));
+    return hash;
+  }
+
+  bool PlanCache::find(const PlanKey& key, TilePlan& plan)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entryMap.find(key);
+    if (it == entryMap.end())
+    {
+      numMisses++;
+      return false;
+    }
+
+    // Move the entry to the front of the list
+    entries.splice(entries.begin(), entries, it->second);
+    plan = it->second->second;
+    numHits++;
+    return true;
+  }
+
+  void PlanCache::insert(const PlanKey& key, const TilePlan& plan)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entryMap.find(key);
+    if (it != entryMap.end())
+    {
+      it->second->second = plan;
+      entries.splice(entries.begin(), entries, it->second);
+      return;
+    }
+
+    entries.emplace_front(key, plan);
+    entryMap[key] = entries.begin();
+
+    // Evict the least recently used entry if the cache is full
+    if (entries.size() > capacity)
+    {
+      entryMap.erase(entries.back().first);
+      entries.pop_back();
+    }
+  }
+
+OIDN_NAMESPACE_END
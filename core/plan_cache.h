@@ -0,0 +1,83 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "common/common.h"
+#include <list>
+#include <unordered_map>
+#include <mutex>
+
+OIDN_NAMESPACE_BEGIN
+
+  // Filter configuration which determines the execution plan
+  struct PlanKey
+  {
+    uint64_t weightsHash = 0;      // hash of the weights blob contents
+    size_t weightsByteSize = 0;
+    int H = 0;                     // image height (of the whole batch)
+    int W = 0;                     // image width
+    int batchSize = 1;
+    Format colorFormat  = Format::Undefined;
+    Format albedoFormat = Format::Undefined;
+    Format normalFormat = Format::Undefined;
+    Format outputFormat = Format::Undefined;
+    Quality quality = Quality::Default;
+    Precision precision = Precision::Default;
+    int maxMemoryMB = -1;
+    bool hdr = false;
+    bool inplace = false;
+    bool autotune = false;
+    bool skipConstantTiles = false;
+
+    bool operator ==(const PlanKey& other) const;
+    size_t getHash() const;
+  };
+
+  // Tile geometry found by searching for a configuration that fits in the memory limit, optionally
+  // refined by autotuning
+  struct TilePlan
+  {
+    int tileH = 0;
+    int tileW = 0;
+    int tileB = 1;
+    int tileCountH = 1;
+    int tileCountW = 1;
+    int tileCountB = 1;
+  };
+
+  // Memoizes the tile plans of filter configurations to make re-committing a previously seen
+  // configuration (e.g. when resizing back and forth) cheap. The least recently used plans are
+  // evicted if the cache is full
+  class PlanCache final
+  {
+  public:
+    static constexpr size_t defaultCapacity = 256;
+
+    explicit PlanCache(size_t capacity = defaultCapacity) : capacity(capacity) {}
+
+    // Looks up the plan for a configuration, and updates the hit/miss counters
+    bool find(const PlanKey& key, TilePlan& plan);
+
+    void insert(const PlanKey& key, const TilePlan& plan);
+
+    int getNumHits() const { return numHits; }
+    int getNumMisses() const { return numMisses; }
+
+  private:
+    struct KeyHash
+    {
+      size_t operator ()(const PlanKey& key) const { return key.getHash(); }
+    };
+
+    using Entry = std::pair<PlanKey, TilePlan>;
+
+    size_t capacity;
+    std::list<Entry> entries; // most recently used first
+    std::unordered_map<PlanKey, std::list<Entry>::iterator, KeyHash> entryMap;
+    int numHits = 0;
+    int numMisses = 0;
+    std::mutex mutex;
+  };
+
+OIDN_NAMESPACE_END
@@ -30,11 +30,11 @@ OIDN_NAMESPACE_BEGIN
     if (progress->isCancelled())
       throw Exception(Error::Cancelled, "execution was cancelled");
 
-    if (!progress->started || delta != 0) // always submit the first update
-    {
+    // Always submit the first update
+    // The progress may be shared by multiple threads submitting to different engines
+    const bool first = !progress->started.exchange(true);
+    if (first || delta != 0)
       engine->submitHostFunc([progress, delta]() { progress->update(delta); }, progress);
-      progress->started = true;
-    }
   }
 
 OIDN_NAMESPACE_END
@@ -37,9 +37,9 @@ OIDN_NAMESPACE_BEGIN
   private:
     ProgressMonitorFunction func;
     void* userPtr;
-    size_t total;     // maximum progress value
-    size_t current;   // current progress value
-    bool started;     // whether any progress updates have been submitted yet
+    size_t total;              // maximum progress value
+    size_t current;            // current progress value
+    std::atomic<bool> started; // whether any progress updates have been submitted yet
     std::mutex mutex;
 
     void update(size_t delta);
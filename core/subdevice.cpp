@@ -25,12 +25,4 @@ OIDN_NAMESPACE_BEGIN
       scratchArenaManager->trim();
   }
 
-  std::shared_ptr<TensorMap> Subdevice::getCachedTensors(const void* key)
-  {
-    std::shared_ptr<TensorMap>& tensorMap = cachedTensors[key];
-    if (!tensorMap)
-      tensorMap = std::make_shared<TensorMap>();
-    return tensorMap;
-  }
-
 OIDN_NAMESPACE_END
\ No newline at end of file
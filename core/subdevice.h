@@ -5,7 +5,7 @@
 
 #include "device.h"
 #include "arena.h"
-#include "tensor.h"
+#include "weights_cache.h"
 
 OIDN_NAMESPACE_BEGIN
 
@@ -21,8 +21,8 @@ OIDN_NAMESPACE_BEGIN
     Ref<Arena> newScratchArena(size_t byteSize, const std::string& name = "");
     void trimScratch();
 
-    // Tensor cache
-    std::shared_ptr<TensorMap> getCachedTensors(const void* key);
+    // Cache of final weights shared by the filters
+    WeightsCache& getWeightsCache() { return weightsCache; }
 
   private:
     // Disable copying
@@ -33,7 +33,7 @@ OIDN_NAMESPACE_BEGIN
 
     // Resources
     std::unique_ptr<ScratchArenaManager> scratchArenaManager;
-    std::unordered_map<const void*, std::shared_ptr<TensorMap>> cachedTensors; // cached weights
+    WeightsCache weightsCache;
   };
 
 OIDN_NAMESPACE_END
\ No newline at end of file
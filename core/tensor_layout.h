@@ -22,6 +22,10 @@ OIDN_NAMESPACE_BEGIN
     OIhw8i16o2i,  // blocked (Xe-HPC DPAS)
     IOhw8i8o,     // blocked
     IOhw16i16o,   // blocked
+    WIOhw8i8o,    // blocked, Winograd F(4x4,3x3) transformed (h = w = 6)
+    WIOhw16i16o,  // blocked, Winograd F(4x4,3x3) transformed (h = w = 6)
+    IOhw2i8o4i,   // blocked (int8 dot products of 4 input channels)
+    IOhw4i16o4i,  // blocked (int8 dot products of 4 input channels)
 
     hwc,
     ohwi,
@@ -266,6 +270,68 @@ OIDN_NAMESPACE_BEGIN
     using ByteOffset = TensorByteOffsetIOhwBiBo<T, 16>;
   };
 
+  template<typename T, int B>
+  struct TensorByteOffsetIOhwBiBo4i
+  {
+    static constexpr oidn_constant int blockC = B; // block channels
+
+    static constexpr oidn_constant uint32_t iByteStride  = sizeof(T);       // within 4 channels
+    static constexpr oidn_constant uint32_t BoByteStride = 4 * iByteStride;
+    static constexpr oidn_constant uint32_t BiByteStride = B * BoByteStride; // 4 channels
+    static constexpr oidn_constant uint32_t wByteStride  = B * B * iByteStride;
+    uint32_t hByteStride;
+    uint32_t OByteStride;
+    uint32_t IByteStride;
+
+    TensorByteOffsetIOhwBiBo4i() = default;
+
+    oidn_host_device_inline TensorByteOffsetIOhwBiBo4i(int O, int I, int H, int W)
+    {
+      hByteStride = uint32_t(W)     * wByteStride;
+      OByteStride = uint32_t(H)     * hByteStride;
+      IByteStride = uint32_t(O / B) * OByteStride;
+    }
+
+    oidn_host_device_inline uint32_t operator ()(int o, int i, int h, int w) const
+    {
+      return uint32_t(i / B)     * IByteStride  +
+             uint32_t(o / B)     * OByteStride  +
+             uint32_t(h)         * hByteStride  +
+             uint32_t(w)         * wByteStride  +
+             uint32_t(i % B / 4) * BiByteStride +
+             uint32_t(o % B)     * BoByteStride +
+             uint32_t(i % 4)     * iByteStride;
+    }
+  };
+
+  template<>
+  struct TensorLayoutTraits<TensorLayout::IOhw2i8o4i>
+  {
+    template<typename T>
+    using ByteOffset = TensorByteOffsetIOhwBiBo4i<T, 8>;
+  };
+
+  template<>
+  struct TensorLayoutTraits<TensorLayout::IOhw4i16o4i>
+  {
+    template<typename T>
+    using ByteOffset = TensorByteOffsetIOhwBiBo4i<T, 16>;
+  };
+
+  template<>
+  struct TensorLayoutTraits<TensorLayout::WIOhw8i8o>
+  {
+    template<typename T>
+    using ByteOffset = TensorByteOffsetIOhwBiBo<T, 8>;
+  };
+
+  template<>
+  struct TensorLayoutTraits<TensorLayout::WIOhw16i16o>
+  {
+    template<typename T>
+    using ByteOffset = TensorByteOffsetIOhwBiBo<T, 16>;
+  };
+
   template<typename T, int P, int Q, int R, int S>
   struct TensorByteOffsetOIhwPoQiRoSi
   {
@@ -380,8 +446,12 @@ OIDN_NAMESPACE_BEGIN
       return {4, 1};
     case TensorLayout::IOhw8i8o:
     case TensorLayout::OIhw8i8o:
+    case TensorLayout::WIOhw8i8o:
+    case TensorLayout::IOhw2i8o4i:
       return {4, 8};
     case TensorLayout::IOhw16i16o:
+    case TensorLayout::WIOhw16i16o:
+    case TensorLayout::IOhw4i16o4i:
     case TensorLayout::OIhw16i16o:
     case TensorLayout::OIhw2o8i8o2i:
     case TensorLayout::OIhw8i16o2i:
@@ -406,6 +476,10 @@ OIDN_NAMESPACE_BEGIN
     case TensorLayout::OIhw8i16o2i:  sm << "OIhw8i16o2i";  break;
     case TensorLayout::IOhw8i8o:     sm << "IOhw8i8o";     break;
     case TensorLayout::IOhw16i16o:   sm << "IOhw16i16o";   break;
+    case TensorLayout::WIOhw8i8o:    sm << "WIOhw8i8o";    break;
+    case TensorLayout::WIOhw16i16o:  sm << "WIOhw16i16o";  break;
+    case TensorLayout::IOhw2i8o4i:   sm << "IOhw2i8o4i";   break;
+    case TensorLayout::IOhw4i16o4i:  sm << "IOhw4i16o4i";  break;
     case TensorLayout::hwc:          sm << "hwc";          break;
     case TensorLayout::ohwi:         sm << "ohwi";         break;
     default:                         sm << "?";            break;
@@ -41,6 +41,76 @@ OIDN_NAMESPACE_BEGIN
     return true;
   }
 
+  // Winograd F(4x4,3x3) weight transform for one dimension: G * g
+  template<typename T>
+  oidn_inline void transformWinogradWeight(const T g[3], T u[6])
+  {
+    u[0] = g[0] / T(4);
+    u[1] = -(g[0] + g[1] + g[2]) / T(6);
+    u[2] = -(g[0] - g[1] + g[2]) / T(6);
+    u[3] = g[0] / T(24) + g[1] / T(12) + g[2] / T(6);
+    u[4] = g[0] / T(24) - g[1] / T(12) + g[2] / T(6);
+    u[5] = g[2];
+  }
+
+  // Reorders 3x3 weights and applies the Winograd F(4x4,3x3) transform (G * g * G^T) to them
+  template<typename SrcT, typename DstT, TensorLayout srcLayout, TensorLayout dstLayout>
+  bool tryReorderWeightWinograd(Tensor& src, int srcBeginI, int srcI, Tensor& dst, int dstBeginI, int dstI)
+  {
+    assert(srcBeginI + srcI <= src.getPaddedI());
+    assert(dstBeginI + dstI <= dst.getPaddedI());
+
+    if (src.getDataType() != DataTypeOf<SrcT>::value || src.getLayout() != srcLayout ||
+        dst.getDataType() != DataTypeOf<DstT>::value || dst.getLayout() != dstLayout)
+      return false;
+
+    if (src.getH() != 3 || src.getW() != 3 || dst.getH() != 6 || dst.getW() != 6)
+      throw std::logic_error("invalid Winograd weight shape");
+
+    TensorAccessor4D<SrcT, srcLayout> srcAcc = src;
+    TensorAccessor4D<DstT, dstLayout> dstAcc = dst;
+
+    for (int o = 0; o < dstAcc.O; ++o)
+    {
+      for (int i = 0; i < dstI; ++i)
+      {
+        float g[3][3];
+        for (int h = 0; h < 3; ++h)
+        {
+          for (int w = 0; w < 3; ++w)
+          {
+            if (o < srcAcc.O && i < srcI)
+              g[h][w] = float(srcAcc(o, srcBeginI + i, h, w));
+            else
+              g[h][w] = 0; // padding
+          }
+        }
+
+        // G * g
+        float t[6][3];
+        for (int w = 0; w < 3; ++w)
+        {
+          const float gCol[3] = {g[0][w], g[1][w], g[2][w]};
+          float tCol[6];
+          transformWinogradWeight(gCol, tCol);
+          for (int h = 0; h < 6; ++h)
+            t[h][w] = tCol[h];
+        }
+
+        // (G * g) * G^T
+        for (int h = 0; h < 6; ++h)
+        {
+          float u[6];
+          transformWinogradWeight(t[h], u);
+          for (int w = 0; w < 6; ++w)
+            dstAcc(o, dstBeginI + i, h, w) = DstT(u[w]);
+        }
+      }
+    }
+
+    return true;
+  }
+
   void reorderWeight(Tensor& src, int srcBeginI, int srcI, Tensor& dst, int dstBeginI, int dstI)
   {
     bool ok =
@@ -52,8 +122,11 @@ OIDN_NAMESPACE_BEGIN
       tryReorderWeight<half, float, TensorLayout::oihw, TensorLayout::OIhw16i16o>  (src, srcBeginI, srcI, dst, dstBeginI, dstI) ||
       tryReorderWeight<half, half,  TensorLayout::oihw, TensorLayout::OIhw2o8i8o2i>(src, srcBeginI, srcI, dst, dstBeginI, dstI) ||
       tryReorderWeight<half, half,  TensorLayout::oihw, TensorLayout::OIhw8i16o2i> (src, srcBeginI, srcI, dst, dstBeginI, dstI) ||
+      tryReorderWeight<half, bfloat16, TensorLayout::oihw, TensorLayout::OIhw8i16o2i>(src, srcBeginI, srcI, dst, dstBeginI, dstI) ||
       tryReorderWeight<half, float, TensorLayout::oihw, TensorLayout::IOhw8i8o>    (src, srcBeginI, srcI, dst, dstBeginI, dstI) ||
       tryReorderWeight<half, float, TensorLayout::oihw, TensorLayout::IOhw16i16o>  (src, srcBeginI, srcI, dst, dstBeginI, dstI) ||
+      tryReorderWeightWinograd<half, float, TensorLayout::oihw, TensorLayout::WIOhw8i8o>  (src, srcBeginI, srcI, dst, dstBeginI, dstI) ||
+      tryReorderWeightWinograd<half, float, TensorLayout::oihw, TensorLayout::WIOhw16i16o>(src, srcBeginI, srcI, dst, dstBeginI, dstI) ||
       tryReorderWeight<half, half,  TensorLayout::oihw, TensorLayout::ohwi>        (src, srcBeginI, srcI, dst, dstBeginI, dstI) ||
       tryReorderWeight<half, float, TensorLayout::oihw, TensorLayout::ohwi>        (src, srcBeginI, srcI, dst, dstBeginI, dstI);
 
@@ -66,8 +139,67 @@ OIDN_NAMESPACE_BEGIN
     reorderWeight(src, 0, src.getI(), dst, 0, dst.getPaddedI());
   }
 
+  template<TensorLayout srcLayout, TensorLayout dstLayout>
+  bool tryQuantizeWeight(Tensor& src, const std::vector<float>& srcScales, float dstScale,
+                         Tensor& dst, Tensor& dstWeightScale)
+  {
+    if (src.getDataType() != DataType::Float32 || src.getLayout() != srcLayout ||
+        dst.getDataType() != DataType::Int8    || dst.getLayout() != dstLayout)
+      return false;
+
+    if (src.getPaddedO() != dst.getPaddedO() || src.getPaddedI() != dst.getPaddedI() ||
+        src.getH() != dst.getH() || src.getW() != dst.getW() ||
+        int(srcScales.size()) != src.getPaddedI() ||
+        dstWeightScale.getDataType() != DataType::Float32 ||
+        dstWeightScale.getPaddedX() != dst.getPaddedO())
+      throw std::logic_error("invalid weight quantization shape");
+
+    TensorAccessor4D<float,  srcLayout> srcAcc = src;
+    TensorAccessor4D<int8_t, dstLayout> dstAcc = dst;
+    TensorAccessor1D<float> scaleAcc = dstWeightScale;
+
+    for (int o = 0; o < dstAcc.O; ++o)
+    {
+      // Symmetric quantization to [-127, 127]
+      float maxAbsValue = 0.f;
+      for (int i = 0; i < dstAcc.I; ++i)
+        for (int h = 0; h < dstAcc.H; ++h)
+          for (int w = 0; w < dstAcc.W; ++w)
+            maxAbsValue = max(maxAbsValue, std::abs(srcAcc(o, i, h, w) * srcScales[i]));
+
+      const float scale = (maxAbsValue > 0.f) ? (maxAbsValue / 127.f) : 1.f;
+
+      for (int i = 0; i < dstAcc.I; ++i)
+      {
+        for (int h = 0; h < dstAcc.H; ++h)
+        {
+          for (int w = 0; w < dstAcc.W; ++w)
+          {
+            const float value = std::round(srcAcc(o, i, h, w) * srcScales[i] / scale);
+            dstAcc(o, i, h, w) = int8_t(clamp(value, -127.f, 127.f));
+          }
+        }
+      }
+
+      scaleAcc(o) = (dstScale > 0.f) ? (scale / dstScale) : scale;
+    }
+
+    return true;
+  }
+
+  void quantizeWeight(Tensor& src, const std::vector<float>& srcScales, float dstScale,
+                      Tensor& dst, Tensor& dstWeightScale)
+  {
+    bool ok =
+      tryQuantizeWeight<TensorLayout::IOhw8i8o,   TensorLayout::IOhw2i8o4i> (src, srcScales, dstScale, dst, dstWeightScale) ||
+      tryQuantizeWeight<TensorLayout::IOhw16i16o, TensorLayout::IOhw4i16o4i>(src, srcScales, dstScale, dst, dstWeightScale);
+
+    if (!ok)
+      throw std::logic_error("unsupported weight quantization layout or data type");
+  }
+
   template<typename SrcT, typename DstT>
-  bool tryReorderBias(Tensor& src, Tensor& dst)
+  bool tryReorderBias(Tensor& src, Tensor& dst, float scale)
   {
     if (src.getDataType() != DataTypeOf<SrcT>::value ||
         dst.getDataType() != DataTypeOf<DstT>::value)
@@ -79,7 +211,7 @@ OIDN_NAMESPACE_BEGIN
     const int srcX = src.getX();
 
     for (int x = 0; x < srcX; ++x)
-      dstAcc(x) = srcAcc(x);
+      dstAcc(x) = (scale == 1.f) ? DstT(srcAcc(x)) : DstT(float(srcAcc(x)) * scale);
 
     for (int x = srcX; x < dstAcc.X; ++x)
       dstAcc(x) = 0; // padding
@@ -87,11 +219,11 @@ OIDN_NAMESPACE_BEGIN
     return true;
   }
 
-  void reorderBias(Tensor& src, Tensor& dst)
+  void reorderBias(Tensor& src, Tensor& dst, float scale)
   {
     bool ok = src.getLayout() == TensorLayout::x && dst.getLayout() == TensorLayout::x &&
-      (tryReorderBias<half, half> (src, dst) ||
-       tryReorderBias<half, float>(src, dst));
+      (tryReorderBias<half, half> (src, dst, scale) ||
+       tryReorderBias<half, float>(src, dst, scale));
 
     if (!ok)
       throw std::logic_error("unsupported bias layout or data type");
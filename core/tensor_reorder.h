@@ -2,11 +2,18 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "tensor.h"
+#include <vector>
 
 OIDN_NAMESPACE_BEGIN
 
   void reorderWeight(Tensor& src, int srcBeginI, int srcI, Tensor& dst, int dstBeginI, int dstI);
   void reorderWeight(Tensor& src, Tensor& dst);
-  void reorderBias(Tensor& src, Tensor& dst);
+  void reorderBias(Tensor& src, Tensor& dst, float scale = 1.f);
+
+  // Quantizes reordered floating-point weights to int8 with a dequantization scale for each output
+  // channel. The weights are multiplied by the quantization scales of the source channels and the
+  // dequantization scales are divided by the quantization scale of the destination (if not zero)
+  void quantizeWeight(Tensor& src, const std::vector<float>& srcScales, float dstScale,
+                      Tensor& dst, Tensor& dstWeightScale);
 
 OIDN_NAMESPACE_END
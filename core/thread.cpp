@@ -20,11 +20,50 @@ OIDN_NAMESPACE_BEGIN
 
 #if defined(_WIN32)
 
+  std::vector<int> getNUMANodes()
+  {
+    return {};
+  }
+
+  CPUCacheSizes getCPUCacheSizes()
+  {
+    CPUCacheSizes sizes;
+
+    // First call the function with an empty buffer to get the required buffer size
+    DWORD bufferSize = 0;
+    if (GetLogicalProcessorInformation(nullptr, &bufferSize) ||
+        GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+      return sizes;
+
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> buffer(
+      bufferSize / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!GetLogicalProcessorInformation(buffer.data(), &bufferSize))
+      return sizes;
+
+    // Find the data/unified caches of the first logical processor
+    for (const auto& item : buffer)
+    {
+      if (item.Relationship != RelationCache || !(item.ProcessorMask & 1) ||
+          (item.Cache.Type != CacheData && item.Cache.Type != CacheUnified))
+        continue;
+
+      switch (item.Cache.Level)
+      {
+      case 1: sizes.L1 = item.Cache.Size; break;
+      case 2: sizes.L2 = item.Cache.Size; break;
+      case 3: sizes.L3 = item.Cache.Size; break;
+      }
+    }
+
+    return sizes;
+  }
+
   // -----------------------------------------------------------------------------------------------
   // ThreadAffinity: Windows
   // -----------------------------------------------------------------------------------------------
 
-  ThreadAffinity::ThreadAffinity(int maxNumThreadsPerCore, int verbose)
+  // NUMA nodes are not supported, all threads are used
+  ThreadAffinity::ThreadAffinity(int maxNumThreadsPerCore, int verbose, int numaNode)
     : Verbose(verbose)
   {
     HMODULE hLib = GetModuleHandle(TEXT("kernel32"));
@@ -131,7 +170,66 @@ OIDN_NAMESPACE_BEGIN
   // ThreadAffinity: Linux
   // -----------------------------------------------------------------------------------------------
 
-  ThreadAffinity::ThreadAffinity(int maxNumThreadsPerCore, int verbose)
+  std::vector<int> getNUMANodes()
+  {
+    std::vector<int> nodeIDs;
+    for (int nodeID : ThreadAffinity::parseList("/sys/devices/system/node/online"))
+    {
+      // Skip nodes without CPUs (e.g. memory-only nodes)
+      if (!ThreadAffinity::parseList("/sys/devices/system/node/node" + std::to_string(nodeID) + "/cpulist").empty())
+        nodeIDs.push_back(nodeID);
+    }
+    return nodeIDs;
+  }
+
+  CPUCacheSizes getCPUCacheSizes()
+  {
+    CPUCacheSizes sizes;
+
+    // Parse the caches of the first CPU from /sys/devices/system/cpu/cpu0/cache/index*
+    for (int index = 0; ; ++index)
+    {
+      const std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+
+      int level = 0;
+      std::string type;
+      std::string sizeStr;
+      std::ifstream levelFile(dir + "level");
+      std::ifstream typeFile(dir + "type");
+      std::ifstream sizeFile(dir + "size");
+      if (!(levelFile >> level) || !(typeFile >> type) || !(sizeFile >> sizeStr))
+        break;
+
+      if (type != "Data" && type != "Unified")
+        continue;
+
+      // The size has a K, M or G suffix
+      size_t size = 0;
+      size_t i = 0;
+      for (; i < sizeStr.size() && sizeStr[i] >= '0' && sizeStr[i] <= '9'; ++i)
+        size = size * 10 + (sizeStr[i] - '0');
+      if (i < sizeStr.size())
+      {
+        switch (sizeStr[i])
+        {
+        case 'K': size <<= 10; break;
+        case 'M': size <<= 20; break;
+        case 'G': size <<= 30; break;
+        }
+      }
+
+      switch (level)
+      {
+      case 1: sizes.L1 = size; break;
+      case 2: sizes.L2 = size; break;
+      case 3: sizes.L3 = size; break;
+      }
+    }
+
+    return sizes;
+  }
+
+  ThreadAffinity::ThreadAffinity(int maxNumThreadsPerCore, int verbose, int numaNode)
     : Verbose(verbose)
   {
     // Get the process affinity mask
@@ -142,6 +240,19 @@ OIDN_NAMESPACE_BEGIN
       return;
     }
 
+    // Restrict the affinity to the CPUs of the NUMA node
+    if (numaNode >= 0)
+    {
+      cpu_set_t nodeAffinity;
+      CPU_ZERO(&nodeAffinity);
+      for (int cpuID : parseList("/sys/devices/system/node/node" + std::to_string(numaNode) + "/cpulist"))
+      {
+        if (cpuID < CPU_SETSIZE && CPU_ISSET(cpuID, &processAffinity))
+          CPU_SET(cpuID, &nodeAffinity);
+      }
+      processAffinity = nodeAffinity;
+    }
+
     // Parse the thread/CPU topology
     std::vector<int> threadIDs;
     std::unordered_set<int> visitedThreadIDs;
@@ -253,11 +364,29 @@ OIDN_NAMESPACE_BEGIN
 
 #elif defined(__APPLE__)
 
+  std::vector<int> getNUMANodes()
+  {
+    return {};
+  }
+
+  CPUCacheSizes getCPUCacheSizes()
+  {
+    // On CPUs with performance and efficiency cores, get the caches of the performance cores
+    CPUCacheSizes sizes;
+    if (!getSysctl("hw.perflevel0.l1dcachesize", sizes.L1))
+      getSysctl("hw.l1dcachesize", sizes.L1);
+    if (!getSysctl("hw.perflevel0.l2cachesize", sizes.L2))
+      getSysctl("hw.l2cachesize", sizes.L2);
+    getSysctl("hw.l3cachesize", sizes.L3);
+    return sizes;
+  }
+
   // -----------------------------------------------------------------------------------------------
   // ThreadAffinity: macOS
   // -----------------------------------------------------------------------------------------------
 
-  ThreadAffinity::ThreadAffinity(int maxNumThreadsPerCore, int verbose)
+  // NUMA nodes are not supported, all threads are used
+  ThreadAffinity::ThreadAffinity(int maxNumThreadsPerCore, int verbose, int numaNode)
     : Verbose(verbose)
   {
     // Query the thread/CPU topology
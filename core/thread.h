@@ -97,6 +97,28 @@ OIDN_NAMESPACE_BEGIN
     std::mutex mutex;
   };
 
+  // -----------------------------------------------------------------------------------------------
+  // NUMA
+  // -----------------------------------------------------------------------------------------------
+
+  // Returns the IDs of the NUMA nodes which have CPUs, or an empty list if NUMA is not supported
+  std::vector<int> getNUMANodes();
+
+  // -----------------------------------------------------------------------------------------------
+  // CPU caches
+  // -----------------------------------------------------------------------------------------------
+
+  // Sizes of the data caches seen by a CPU core in bytes, or 0 if unknown
+  struct CPUCacheSizes
+  {
+    size_t L1 = 0; // private L1 data cache
+    size_t L2 = 0; // L2 cache (private or shared by a few cores)
+    size_t L3 = 0; // last level cache shared by multiple cores
+  };
+
+  // Returns the cache sizes of the first CPU core
+  CPUCacheSizes getCPUCacheSizes();
+
 #if defined(_WIN32)
 
   // -----------------------------------------------------------------------------------------------
@@ -106,7 +128,7 @@ OIDN_NAMESPACE_BEGIN
   class ThreadAffinity : public Verbose
   {
   public:
-    ThreadAffinity(int maxNumThreadsPerCore = INT_MAX, int verbose = 0);
+    ThreadAffinity(int maxNumThreadsPerCore = INT_MAX, int verbose = 0, int numaNode = -1);
 
     int getNumThreads() const
     {
@@ -144,7 +166,7 @@ OIDN_NAMESPACE_BEGIN
   class ThreadAffinity : public Verbose
   {
   public:
-    ThreadAffinity(int maxNumThreadsPerCore = INT_MAX, int verbose = 0);
+    ThreadAffinity(int maxNumThreadsPerCore = INT_MAX, int verbose = 0, int numaNode = -1);
 
     int getNumThreads() const
     {
@@ -158,6 +180,8 @@ OIDN_NAMESPACE_BEGIN
     void restore(int threadIndex);
 
   private:
+    friend std::vector<int> getNUMANodes();
+
     // Parses a list of numbers from a file in /sys/devices/system
     static std::vector<int> parseList(const std::string& filename);
 
@@ -174,7 +198,7 @@ OIDN_NAMESPACE_BEGIN
   class ThreadAffinity : public Verbose
   {
   public:
-    ThreadAffinity(int maxNumThreadsPerCore = INT_MAX, int verbose = 0);
+    ThreadAffinity(int maxNumThreadsPerCore = INT_MAX, int verbose = 0, int numaNode = -1);
 
     int getNumThreads() const
     {
@@ -0,0 +1,82 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "op.h"
+#include "image.h"
+#include "color.h"
+#include "tile.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  struct TilePassThroughDesc
+  {
+    std::shared_ptr<TransferFunction> transferFunc; // only the input/output scales are used
+    bool hdr;
+    bool snorm;
+  };
+
+  // Copies the main input image in a tile to the output instead of denoising it (e.g. for constant
+  // tiles). The values are sanitized and clamped like by the input and output processing, so the
+  // passed through tiles match the denoised ones
+  class TilePassThrough : public BaseOp, protected TilePassThroughDesc
+  {
+  public:
+    TilePassThrough(const TilePassThroughDesc& desc)
+      : TilePassThroughDesc(desc) {}
+
+    void setSrc(const Ref<Image>& src) { this->src = src; }
+    void setDst(const Ref<Image>& dst) { this->dst = dst; }
+
+    void setTile(int h, int w, int H, int W)
+    {
+      tile.hSrcBegin = h;
+      tile.wSrcBegin = w;
+      tile.hDstBegin = h;
+      tile.wDstBegin = w;
+      tile.H = H;
+      tile.W = W;
+    }
+
+    // Sets the number of images in the tile and the row stride between them (the tile is at the
+    // same position in all images)
+    void setBatch(int count, int hStride)
+    {
+      if (count < 1)
+        throw std::invalid_argument("invalid tile pass-through batch");
+      batchCount = count;
+      hBatchStride = hStride;
+    }
+
+    bool getAccesses(std::vector<MemoryAccess>& accesses) const override
+    {
+      addAccess(accesses, src, false);
+      if (transferFunc->inputScalePtr) // computed by autoexposure
+        addAccess(accesses, transferFunc->inputScalePtr, sizeof(float), false);
+      addAccess(accesses, dst, true);
+      return true;
+    }
+
+  protected:
+    void check()
+    {
+      if (!src || !dst)
+        throw std::logic_error("tile pass-through source/destination not set");
+      for (const auto& image : {src, dst})
+      {
+        if (tile.H <= 0 || tile.W <= 0 ||
+            tile.hSrcBegin + (batchCount-1) * hBatchStride + tile.H > image->getH() ||
+            tile.wSrcBegin + tile.W > image->getW())
+          throw std::out_of_range("tile pass-through source/destination out of bounds");
+      }
+    }
+
+    Ref<Image> src;
+    Ref<Image> dst;
+    Tile tile{};          // the source and destination positions are the same
+    int batchCount = 1;   // number of images in the tile
+    int hBatchStride = 0; // row stride between the images
+  };
+
+OIDN_NAMESPACE_END
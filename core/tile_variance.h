@@ -0,0 +1,86 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "op.h"
+#include "image.h"
+#include "record.h"
+#include "tile.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  // Computes the maximum variance over all channels of the input images (color, albedo, normal) in
+  // a tile, which is used for detecting constant tiles (e.g. empty background) that do not need to
+  // be denoised. The tile is reduced in bins like in the autoexposure. The result is NaN if the
+  // tile contains NaN or infinite values
+  class TileVariance : public BaseOp
+  {
+  public:
+    static constexpr int maxBinSize = 16;
+
+    void setSrc(const Ref<Image>& color, const Ref<Image>& albedo, const Ref<Image>& normal)
+    {
+      this->color  = color;
+      this->albedo = albedo;
+      this->normal = normal;
+    }
+
+    void setTile(int h, int w, int H, int W)
+    {
+      tile.hSrcBegin = h;
+      tile.wSrcBegin = w;
+      tile.H = H;
+      tile.W = W;
+    }
+
+    // Sets the number of images in the tile and the row stride between them in the source (the
+    // tile is at the same position in all images)
+    void setBatch(int count, int hSrcStride)
+    {
+      if (count < 1)
+        throw std::invalid_argument("invalid tile variance batch");
+      batchCount = count;
+      hSrcBatchStride = hSrcStride;
+    }
+
+    void setDst(const Ref<Record<float>>& dst) { this->dst = dst; }
+    float* getDstPtr() const { return dst->getPtr(); }
+
+    bool getAccesses(std::vector<MemoryAccess>& accesses) const override
+    {
+      addAccess(accesses, color, false);
+      addAccess(accesses, albedo, false);
+      addAccess(accesses, normal, false);
+      if (dst)
+        addAccess(accesses, dst->getPtr(), sizeof(float), true);
+      return true;
+    }
+
+  protected:
+    void check()
+    {
+      if (!color && !albedo && !normal)
+        throw std::logic_error("tile variance source not set");
+      if (!dst)
+        throw std::logic_error("tile variance destination not set");
+
+      for (const auto& src : {color, albedo, normal})
+      {
+        if (src && (tile.H <= 0 || tile.W <= 0 ||
+                    tile.hSrcBegin + (batchCount-1) * hSrcBatchStride + tile.H > src->getH() ||
+                    tile.wSrcBegin + tile.W > src->getW()))
+          throw std::out_of_range("tile variance source out of bounds");
+      }
+    }
+
+    Ref<Image> color;
+    Ref<Image> albedo;
+    Ref<Image> normal;
+    Ref<Record<float>> dst;
+    Tile tile{};             // only the source position and size are used
+    int batchCount = 1;      // number of images in the tile
+    int hSrcBatchStride = 0; // row stride between the images in the source
+  };
+
+OIDN_NAMESPACE_END
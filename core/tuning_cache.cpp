@@ -0,0 +1,100 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "tuning_cache.h"
+#include <fstream>
+#include <cstdio>
+#include <random>
+
+#if !defined(_WIN32)
+  #include <unistd.h>
+#endif
+
+OIDN_NAMESPACE_BEGIN
+
+  bool TuningCache::find(const std::string& key, int& level)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    load();
+
+    auto it = entries.find(key);
+    if (it == entries.end())
+      return false;
+
+    level = it->second;
+    return true;
+  }
+
+  void TuningCache::insert(const std::string& key, int level)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    load();
+
+    entries[key] = level;
+    save();
+  }
+
+  // Reads the entries from the cache file, one "<key> <level>" pair per line. A missing or
+  // malformed file is not an error, the results are simply tuned again
+  void TuningCache::load()
+  {
+    if (loaded)
+      return;
+    loaded = true;
+
+    if (path.empty())
+      return;
+
+    std::ifstream file(path);
+    std::string key;
+    int level;
+    while (file >> key >> level)
+    {
+      if (level >= 0)
+        entries[key] = level;
+    }
+  }
+
+  void TuningCache::save()
+  {
+    if (path.empty())
+      return;
+
+    // Write to a temporary file first to avoid corrupting the cache if another process reads it.
+    // The name of the file is unique, so processes and devices saving concurrently do not write to
+    // the same temporary file
+  #if defined(_WIN32)
+    const unsigned long processID = GetCurrentProcessId();
+  #else
+    const unsigned long processID = static_cast<unsigned long>(getpid());
+  #endif
+    std::random_device randomDevice;
+    std::ostringstream tempPathStream;
+    tempPathStream << path << "." << processID << "." << std::hex << randomDevice() << ".tmp";
+    const std::string tempPath = tempPathStream.str();
+
+    bool written;
+    {
+      std::ofstream file(tempPath, std::ios::trunc);
+      for (const auto& entry : entries)
+        file << entry.first << " " << entry.second << std::endl;
+      written = bool(file);
+    }
+    if (!written)
+    {
+      std::remove(tempPath.c_str());
+      return; // failing to save the cache is not fatal
+    }
+
+    // Replace the cache file atomically (std::rename fails on Windows if the destination exists)
+  #if defined(_WIN32)
+    const bool renamed =
+      MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+  #else
+    const bool renamed = std::rename(tempPath.c_str(), path.c_str()) == 0;
+  #endif
+    if (!renamed)
+      std::remove(tempPath.c_str());
+  }
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,37 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "common/common.h"
+#include <map>
+#include <mutex>
+
+OIDN_NAMESPACE_BEGIN
+
+  // Persistent cache of the results of tile size autotuning. The entries are identified by a key
+  // describing the device, the weights and the resolution class of the filter, and store the
+  // selected tuning level (the number of times the tile count was doubled compared to the default
+  // tile plan). If a file path is specified, the entries are loaded from it on first access and
+  // saved to it when a new entry is inserted, so the results are reused across processes
+  class TuningCache final
+  {
+  public:
+    explicit TuningCache(const std::string& path = "") : path(path) {}
+
+    bool find(const std::string& key, int& level);
+    void insert(const std::string& key, int level);
+
+    const std::string& getPath() const { return path; }
+
+  private:
+    void load();
+    void save();
+
+    std::string path; // path of the cache file, in-memory only if empty
+    bool loaded = false;
+    std::map<std::string, int> entries;
+    std::mutex mutex;
+  };
+
+OIDN_NAMESPACE_END
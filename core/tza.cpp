@@ -24,6 +24,39 @@ OIDN_NAMESPACE_BEGIN
     return value;
   }
 
+  // Parses a tensor layout, which may be also a blocked weight layout of a device (pre-reordered)
+  static TensorLayout parseTensorLayout(const std::string& str, int ndims)
+  {
+    static const TensorLayout layouts[] =
+    {
+      TensorLayout::x,
+      TensorLayout::oihw,
+      TensorLayout::OIhw8i8o,
+      TensorLayout::OIhw16i16o,
+      TensorLayout::OIhw2o8i8o2i,
+      TensorLayout::OIhw8i16o2i,
+      TensorLayout::IOhw8i8o,
+      TensorLayout::IOhw16i16o,
+    };
+
+    for (TensorLayout layout : layouts)
+    {
+      if (toString(layout) == str)
+      {
+        if (getTensorLayoutInfo(layout).rank != ndims)
+          break;
+        return layout;
+      }
+    }
+
+    throw Exception(Error::InvalidOperation, "invalid tensor layout");
+  }
+
+  std::string getTZAVariantName(const std::string& name, TensorLayout layout, DataType dataType)
+  {
+    return name + "@" + toString(layout) + "_" + toString(dataType);
+  }
+
   std::shared_ptr<TensorMap> parseTZA(const void* buffer, size_t size)
   {
     const char* input = static_cast<const char*>(buffer);
@@ -38,7 +71,7 @@ OIDN_NAMESPACE_BEGIN
     const int majorVersion = read<uint8_t>(input, bufferEnd);
     const int minorVersion = read<uint8_t>(input, bufferEnd);
     UNUSED(minorVersion);
-    if (majorVersion != 2)
+    if (majorVersion != 2 && majorVersion != 3)
       throw Exception(Error::InvalidOperation, "unsupported weights blob version");
 
     // Parse the table offset and jump to the table
@@ -70,15 +103,19 @@ OIDN_NAMESPACE_BEGIN
       tensorDesc.paddedDims = tensorDesc.dims;
 
       // Parse the layout of the tensor
-      checkBounds(input, bufferEnd, ndims);
-      std::string layout = std::string(input, input + ndims);
-      if (layout == "x")
-        tensorDesc.layout = TensorLayout::x;
-      else if (layout == "oihw")
-        tensorDesc.layout = TensorLayout::oihw;
-      else
-        throw Exception(Error::InvalidOperation, "invalid tensor layout");
-      input += ndims;
+      // Since version 3, the layout is prefixed with its length, so blocked layouts can be stored too
+      const size_t layoutLen = (majorVersion >= 3) ? read<uint8_t>(input, bufferEnd) : ndims;
+      checkBounds(input, bufferEnd, layoutLen);
+      tensorDesc.layout = parseTensorLayout(std::string(input, input + layoutLen), ndims);
+      input += layoutLen;
+
+      // Blocked weights are stored with the channels padded to the block size
+      const int blockC = getTensorLayoutInfo(tensorDesc.layout).blockC;
+      if (ndims == 4 && blockC > 1)
+      {
+        tensorDesc.paddedDims[0] = round_up(tensorDesc.dims[0], blockC);
+        tensorDesc.paddedDims[1] = round_up(tensorDesc.dims[1], blockC);
+      }
 
       // Parse the data type of the tensor
       const char dataType = read<char>(input, bufferEnd);
@@ -95,8 +132,13 @@ OIDN_NAMESPACE_BEGIN
       checkBounds(tensorData, bufferEnd, tensorDesc.getByteSize());
 
       // Add the tensor to the map
+      // If the tensor has no plain variant, the first variant is used as the default one
       auto tensor = makeRef<HostTensor>(tensorDesc, const_cast<char*>(tensorData));
-      tensorMap->emplace(name, tensor);
+      tensorMap->emplace(getTZAVariantName(name, tensorDesc.layout, tensorDesc.dataType), tensor);
+      if (tensorDesc.layout == TensorLayout::x || tensorDesc.layout == TensorLayout::oihw)
+        (*tensorMap)[name] = tensor;
+      else
+        tensorMap->emplace(name, tensor);
     }
 
     return tensorMap;
@@ -8,6 +8,12 @@
 OIDN_NAMESPACE_BEGIN
 
   // Parses tensors from a Tensor Archive (TZA)
+  // A tensor may be stored in multiple variants with different layouts and data types (e.g.
+  // pre-reordered for several devices). Each variant is added to the map with the name returned by
+  // getTZAVariantName, and the plain (original) variant is also added with the name of the tensor
   std::shared_ptr<TensorMap> parseTZA(const void* buffer, size_t size);
 
+  // Returns the name of a tensor variant with the specified layout and data type
+  std::string getTZAVariantName(const std::string& name, TensorLayout layout, DataType dataType);
+
 OIDN_NAMESPACE_END
\ No newline at end of file
@@ -3,6 +3,10 @@
 
 #include "unet_filter.h"
 #include "tza.h"
+#include "weights_cache.h"
+#include "common/timer.h"
+#include <atomic>
+#include <thread>
 
 OIDN_NAMESPACE_BEGIN
 
@@ -52,8 +56,32 @@ OIDN_NAMESPACE_BEGIN
         throw Exception(Error::InvalidArgument, "unknown filter quality mode");
       setParam(quality, qualityValue);
     }
+    else if (name == "precision")
+    {
+      const Precision precisionValue = static_cast<Precision>(value);
+      if (precisionValue != Precision::Default && precisionValue != Precision::Int8 &&
+          precisionValue != Precision::FP16)
+        throw Exception(Error::InvalidArgument, "unknown filter precision mode");
+      setParam(precision, precisionValue);
+    }
     else if (name == "maxMemoryMB")
       setParam(maxMemoryMB, value);
+    else if (name == "batchSize")
+    {
+      if (value < 1)
+        throw Exception(Error::InvalidArgument, "invalid filter batch size");
+      setParam(batchSize, value);
+    }
+    else if (name == "stream")
+    {
+      if (value < 0)
+        throw Exception(Error::InvalidArgument, "invalid filter stream");
+      setParam(stream, value);
+    }
+    else if (name == "autotune")
+      setParam(autotune, bool(value));
+    else if (name == "skipConstantTiles")
+      setParam(skipConstantTiles, bool(value));
     else
       device->printWarning("unknown filter parameter or type mismatch: '" + name + "'");
 
@@ -64,8 +92,20 @@ OIDN_NAMESPACE_BEGIN
   {
     if (name == "quality")
       return static_cast<int>(quality);
+    else if (name == "precision")
+      return static_cast<int>(precision);
     else if (name == "maxMemoryMB")
       return maxMemoryMB;
+    else if (name == "batchSize")
+      return batchSize;
+    else if (name == "stream")
+      return stream;
+    else if (name == "autotune")
+      return autotune;
+    else if (name == "skipConstantTiles")
+      return skipConstantTiles;
+    else if (name == "skippedTileCount")
+      return skippedTileCount;
     else if (name == "tileAlignment")
       return tileAlignment;
     else if (name == "alignment")
@@ -93,6 +133,12 @@ OIDN_NAMESPACE_BEGIN
       device->printWarning("filter parameter 'hdrScale' is deprecated, use 'inputScale' instead");
       inputScale = value;
     }
+    else if (name == "constantTileThreshold")
+    {
+      if (!(value >= 0))
+        throw Exception(Error::InvalidArgument, "invalid filter constant tile threshold");
+      constantTileThreshold = value;
+    }
     else
       device->printWarning("unknown filter parameter or type mismatch: '" + name + "'");
 
@@ -108,6 +154,32 @@ OIDN_NAMESPACE_BEGIN
       device->printWarning("filter parameter 'hdrScale' is deprecated, use 'inputScale' instead");
       return inputScale;
     }
+    else if (name == "constantTileThreshold")
+      return constantTileThreshold;
+    else
+      throw Exception(Error::InvalidArgument, "unknown filter parameter or type mismatch: '" + name + "'");
+  }
+
+  void UNetFilter::setString(const std::string& name, const std::string& value)
+  {
+    if (name == "weightsFile")
+    {
+      // The file is mapped again even if its name has not changed because its contents may have changed
+      dirtyParam |= userWeightsFile || !value.empty();
+      userWeightsFile.reset();
+      if (!value.empty())
+        userWeightsFile = std::make_shared<MappedFile>(value);
+    }
+    else
+      device->printWarning("unknown filter parameter or type mismatch: '" + name + "'");
+
+    dirty = true;
+  }
+
+  const char* UNetFilter::getString(const std::string& name)
+  {
+    if (name == "weightsFile")
+      return userWeightsFile ? userWeightsFile->getFilename().c_str() : "";
     else
       throw Exception(Error::InvalidArgument, "unknown filter parameter or type mismatch: '" + name + "'");
   }
@@ -150,18 +222,58 @@ OIDN_NAMESPACE_BEGIN
     if (H <= 0 || W <= 0)
       return;
 
-    device->execute([&]()
+    // On devices with multiple streams, only the stream of the filter is waited for
+    device->execute(stream, [&]()
     {
+      // Find the constant tiles, which are passed through instead of denoising them
+      // The tile variances are needed on the host, so we have to wait for them, even if the
+      // execution is asynchronous (only the denoising of the tiles is asynchronous)
+      std::vector<int> tileIndices;        // tiles to denoise
+      std::vector<int> skippedTileIndices; // tiles to pass through
+      if (tileVariance)
+      {
+        tileVariance->setSrc(color, albedo, normal);
+        for (int tileIndex = 0; tileIndex < getTileCount(); ++tileIndex)
+        {
+          const TileDesc tile = getTileDesc(tileIndex);
+          tileVariance->setTile(tile.b * H + tile.h, tile.w, tile.H1, tile.W1);
+          tileVariance->setBatch(tile.B, H);
+          tileVariance->setDst(tileVarianceDsts[tileIndex]);
+          tileVariance->submit(nullptr);
+        }
+        tileVariance->getEngine()->wait();
+
+        for (int tileIndex = 0; tileIndex < getTileCount(); ++tileIndex)
+        {
+          if (*tileVarianceDsts[tileIndex]->getPtr() <= constantTileThreshold)
+            skippedTileIndices.push_back(tileIndex);
+          else
+            tileIndices.push_back(tileIndex);
+        }
+
+        if (device->isVerbose(2))
+        {
+          std::cout << "Skipped tiles: " << skippedTileIndices.size() << "/" << getTileCount()
+                    << std::endl;
+        }
+      }
+      else
+      {
+        for (int tileIndex = 0; tileIndex < getTileCount(); ++tileIndex)
+          tileIndices.push_back(tileIndex);
+      }
+      skippedTileCount = int(skippedTileIndices.size());
+
       // Initialize the progress state
       Ref<Progress> progress;
       if (progressFunc)
       {
-        size_t workAmount = 0;
-        for (int i = 0; i < device->getNumSubdevices(); ++i)
-          workAmount += instances[i].graph->getWorkAmount();
-        workAmount *= (tileCountH * tileCountW) / device->getNumSubdevices();
+        // The model instances are identical, thus the work amount of a tile is the same on all
+        // subdevices
+        size_t workAmount = instances[0].graph->getWorkAmount() * tileIndices.size();
         if (hdr && math::isnan(inputScale))
-          workAmount += autoexposure->getWorkAmount();
+          workAmount += autoexposure->getWorkAmount() * batchSize;
+        workAmount += tilePassThrough->getWorkAmount() * skippedTileIndices.size();
         if (outputTemp)
           workAmount += imageCopy->getWorkAmount();
 
@@ -169,23 +281,30 @@ OIDN_NAMESPACE_BEGIN
       }
 
       // Set the input scale
+      const float* inputScalePtr = nullptr; // computed input scales for the images in the batch
       if (math::isnan(inputScale))
       {
         if (hdr)
         {
-          autoexposure->setSrc(color);
-          autoexposure->submit(progress);
-          device->submitBarrier();
-          transferFunc->setInputScale(autoexposure->getDstPtr());
+          for (int b = 0; b < batchSize; ++b)
+          {
+            autoexposure->setSrc(batchSize > 1 ? color->getRows(b * H, H) : color);
+            autoexposure->setDst(autoexposureDsts[b]);
+            autoexposure->submit(progress);
+          }
+          device->submitBarrier(stream);
+          inputScalePtr = autoexposureDsts[0]->getPtr();
         }
         else
         {
-          transferFunc->setInputScale(1);
+          for (auto& instance : instances)
+            instance.transferFunc->setInputScale(1);
         }
       }
       else
       {
-        transferFunc->setInputScale(inputScale);
+        for (auto& instance : instances)
+          instance.transferFunc->setInputScale(inputScale);
       }
 
       // Set the input and output
@@ -195,52 +314,174 @@ OIDN_NAMESPACE_BEGIN
         instance.outputProcess->setDst(outputTemp ? outputTemp : output);
       }
 
-      // Iterate over the tiles
-      int tileIndex = 0;
+      // Sets the input scale for the images in the tile starting at the specified image
+      auto setTileInputScale = [&](Instance& instance, int b)
+      {
+        if (inputScalePtr)
+          instance.transferFunc->setInputScale(inputScalePtr + b);
+      };
 
-      for (int i = 0; i < tileCountH; ++i)
+      auto setInputTile = [&](Instance& instance, const TileDesc& tile)
+      {
+        instance.inputProcess->setTile(
+          tile.b * H + tile.h, tile.w,
+          tile.alignOffsetH, tile.alignOffsetW,
+          tile.H1, tile.W1);
+        instance.inputProcess->setBatch(tile.B, H);
+      };
+
+      auto setOutputTile = [&](Instance& instance, const TileDesc& tile)
       {
-        const int h = i * (tileH - (2*tileOverlap+tilePadH)); // input tile position (including overlaps)
-        const int overlapBeginH = i > 0            ? tileOverlap : 0; // overlap on the top
-        const int overlapEndH   = i < tileCountH-1 ? tileOverlap+tilePadH : 0; // overlap on the bottom
-        const int tileH1 = min(H - h, tileH); // input tile size (including overlaps)
-        const int tileH2 = tileH1 - overlapBeginH - overlapEndH; // output tile size
-        const int alignOffsetH = tileH - round_up(tileH1, minTileAlignment); // align to the bottom in the tile buffer
+        instance.outputProcess->setTile(
+          tile.alignOffsetH + tile.overlapBeginH, tile.alignOffsetW + tile.overlapBeginW,
+          tile.b * H + tile.h + tile.overlapBeginH, tile.w + tile.overlapBeginW,
+          tile.H2, tile.W2);
+        instance.outputProcess->setBatch(tile.B, H);
+      };
+
+      // Pass through the constant tiles by copying the main input to the output
+      if (!skippedTileIndices.empty())
+      {
+        tilePassThrough->setSrc(color ? color : (albedo ? albedo : normal));
+        tilePassThrough->setDst(outputTemp ? outputTemp : output);
 
-        for (int j = 0; j < tileCountW; ++j)
+        for (int tileIndex : skippedTileIndices)
         {
-          const int w = j * (tileW - (2*tileOverlap+tilePadW)); // input tile position (including overlaps)
-          const int overlapBeginW = j > 0            ? tileOverlap : 0; // overlap on the left
-          const int overlapEndW   = j < tileCountW-1 ? tileOverlap+tilePadW : 0; // overlap on the right
-          const int tileW1 = min(W - w, tileW); // input tile size (including overlaps)
-          const int tileW2 = tileW1 - overlapBeginW - overlapEndW; // output tile size
-          const int alignOffsetW = tileW - round_up(tileW1, minTileAlignment); // align to the right in the tile buffer
+          const TileDesc tile = getTileDesc(tileIndex);
+          setTileInputScale(instances[0], tile.b);
+          tilePassThrough->setTile(tile.b * H + tile.h + tile.overlapBeginH,
+                                   tile.w + tile.overlapBeginW,
+                                   tile.H2, tile.W2);
+          tilePassThrough->setBatch(tile.B, H);
+          tilePassThrough->submit(progress);
+        }
+      }
 
-          auto& instance = instances[tileIndex % device->getNumSubdevices()];
+      const int tileCount = int(tileIndices.size());
+
+      if (instances.size() == 1)
+      {
+        // Iterate over the tiles
+        // If the graph is pipelined, the input processing of a tile and the output processing of
+        // the previous tile are submitted in the same iteration, running concurrently with the rest
+        auto& instance = instances[0];
+        const bool pipelined = instance.graph->isPipelined();
+        int prevB = 0; // first image of the previous tile
+
+        for (int i = 0; i < tileCount; ++i)
+        {
+          const TileDesc tile = getTileDesc(tileIndices[i]);
+          setTileInputScale(instance, tile.b);
+          setInputTile(instance, tile);
 
-          // Set the input tile
-          instance.inputProcess->setTile(
-            h, w,
-            alignOffsetH, alignOffsetW,
-            tileH1, tileW1);
+          if (pipelined)
+          {
+            instance.graph->submitInput(progress);
 
-          // Set the output tile
-          instance.outputProcess->setTile(
-            alignOffsetH + overlapBeginH, alignOffsetW + overlapBeginW,
-            h + overlapBeginH, w + overlapBeginW,
-            tileH2, tileW2);
+            // Finish the previous tile (the output processing may be fused into the tail)
+            if (i > 0)
+            {
+              setTileInputScale(instance, prevB);
+              instance.graph->submitTail(progress);
+              instance.graph->submitOutput(progress);
+            }
+          }
 
-          //printf("Tile: %d %d -> %d %d\n", w+overlapBeginW, h+overlapBeginH, w+overlapBeginW+tileW2, h+overlapBeginH+tileH2);
+          setOutputTile(instance, tile);
 
           // Denoise the tile
+          if (pipelined)
+          {
+            instance.graph->submitHead(progress);
+            prevB = tile.b;
+          }
+          else
+          {
+            instance.graph->submit(progress);
+          }
+        }
+
+        // Finish the last tile
+        if (pipelined && tileCount > 0)
+        {
+          setTileInputScale(instance, prevB);
+          instance.graph->submitTail(progress);
+          instance.graph->submitOutput(progress);
+          instance.graph->submitJoin();
+        }
+      }
+      else if (sync == SyncMode::Async)
+      {
+        // Asynchronous execution must not block the caller, so the tiles are assigned to the
+        // subdevices round-robin, as the dynamic distribution below waits for the subdevices
+        for (int i = 0; i < tileCount; ++i)
+        {
+          auto& instance = instances[i % instances.size()];
+          const TileDesc tile = getTileDesc(tileIndices[i]);
+          setTileInputScale(instance, tile.b);
+          setInputTile(instance, tile);
+          setOutputTile(instance, tile);
           instance.graph->submit(progress);
+        }
+      }
+      else
+      {
+        // Distribute the tiles dynamically among the subdevices: each subdevice pulls the next
+        // tile from the shared queue only when it has finished the previous one, which balances
+        // the load if the tiles have different costs or the subdevices have different speeds
+        std::atomic<int> nextTileIndex(0);
+        std::vector<std::exception_ptr> errors(instances.size());
+        std::vector<std::thread> threads;
+
+        for (size_t i = 0; i < instances.size(); ++i)
+        {
+          threads.emplace_back([&, i]()
+          {
+            auto& instance = instances[i];
+            Engine* engine = instance.graph->getEngine();
+
+            try
+            {
+              bool busy = false;
+              for (;;)
+              {
+                // The last tile is not waited for, so the execution can be asynchronous
+                if (nextTileIndex >= tileCount)
+                  break;
+                if (busy)
+                  engine->wait(); // wait for the previous tile to finish
+
+                const int tileIndex = nextTileIndex++;
+                if (tileIndex >= tileCount)
+                  break;
+
+                const TileDesc tile = getTileDesc(tileIndices[tileIndex]);
+                setTileInputScale(instance, tile.b);
+                setInputTile(instance, tile);
+                setOutputTile(instance, tile);
+                instance.graph->submit(progress);
+                busy = true;
+              }
+            }
+            catch (...)
+            {
+              errors[i] = std::current_exception();
+              nextTileIndex = tileCount; // stop the other subdevices too
+            }
+          });
+        }
 
-          // Next tile
-          tileIndex++;
+        for (auto& thread : threads)
+          thread.join();
+
+        for (const auto& error : errors)
+        {
+          if (error)
+            std::rethrow_exception(error);
         }
       }
 
-      device->submitBarrier();
+      device->submitBarrier(stream);
 
       // Copy the output image to the final buffer if filtering in-place
       if (outputTemp)
@@ -259,39 +500,66 @@ OIDN_NAMESPACE_BEGIN
     // Select the model
     Data weightsBlob = getWeights();
     auto constTensors = parseTZA(weightsBlob.ptr, weightsBlob.size);
+    const uint64_t weightsHash = getDataHash(weightsBlob.ptr, weightsBlob.size);
     const bool fastMath = quality != Quality::High;
     largeModel = constTensors->find("enc_conv1b.weight") != constTensors->end();
 
+    // Non-default precisions require support from the device, and quantized inference also requires
+    // calibrated weights (with the activation scales of the convolutions), otherwise we fall back
+    // to the default precision
+    Precision tensorPrecision = precision;
+    if (precision != Precision::Default)
+    {
+      const std::string firstConvName = largeModel ? "enc_conv1a" : "enc_conv0";
+      if (!device->getStreamEngine(stream)->isPrecisionSupported(precision))
+      {
+        device->printWarning(toString(precision) + " precision is not supported by the device, using default precision");
+        tensorPrecision = Precision::Default;
+      }
+      else if (precision == Precision::Int8 &&
+               constTensors->find(firstConvName + ".dst_scale") == constTensors->end())
+      {
+        device->printWarning("weights are not calibrated for int8 precision, using default precision");
+        tensorPrecision = Precision::Default;
+      }
+    }
+
+    // Skipping constant tiles requires computing the variance of the tiles on the device
+    tileSkipping = skipConstantTiles && device->getStreamEngine(stream)->isTileVarianceSupported();
+    if (skipConstantTiles && !tileSkipping)
+      device->printWarning("skipping constant tiles is not supported by the device");
+
     // Compute final device-dependent tile alignment and overlap
     const int receptiveField = largeModel ? receptiveFieldLarge : receptiveFieldBase;
     tileAlignment = lcm(minTileAlignment, device->getMinTileAlignment());
     tileOverlap = round_up(receptiveField / 2, tileAlignment);
 
     // Build the model
-    for (int i = 0; i < device->getNumSubdevices(); ++i)
+    for (int i = 0; i < device->getNumStreamSubdevices(); ++i)
     {
-      Engine* engine = device->getEngine(i);
+      Engine* engine = device->getStreamEngine(stream, i);
 
-      // We can use cached weights only for built-in weights because user weights may change!
-      auto cachedConstTensors =
-        userWeightsBlob ? nullptr : engine->getSubdevice()->getCachedTensors(weightsBlob.ptr);
+      // The cache is looked up by the contents of the weights, so it works for user weights too
+      auto cachedConstTensors = engine->getSubdevice()->getWeightsCache().get(weightsBlob, weightsHash);
 
       instances.emplace_back();
-      instances.back().graph = makeRef<Graph>(engine, constTensors, cachedConstTensors, fastMath);
+      instances.back().graph = makeRef<Graph>(engine, constTensors, cachedConstTensors, fastMath, tensorPrecision);
+      instances.back().transferFunc = newTransferFunc();
     }
 
-    transferFunc = newTransferFunc();
-
     // Try to divide the image into tiles until the memory usage gets below the specified threshold
-    // and the number of tiles is a multiple of the number of subdevices
-    H = output->getH();
+    // and there are at least as many tiles as subdevices (the tiles are distributed dynamically)
+    // If supported, the images in the batch are denoised together, otherwise one by one
+    H = output->getH() / batchSize;
     W = output->getW();
     tileH = round_up(H, minTileAlignment); // add minimum device-independent padding
     tileW = round_up(W, minTileAlignment);
+    tileB = device->getStreamEngine(stream)->isBatchSupported() ? batchSize : 1;
     tilePadH = tileH % tileAlignment; // increase the overlap on the bottom to align offsets
     tilePadW = tileW % tileAlignment; // increase the overlap on the right to align offsets
     tileCountH = 1;
     tileCountW = 1;
+    tileCountB = ceil_div(batchSize, tileB);
 
     const int minTileDim = max(4*tileOverlap, 768); // MPS has slightly different output using smaller tiles
     const int minTileH = round_up(minTileDim, tileAlignment, tilePadH);
@@ -300,23 +568,30 @@ OIDN_NAMESPACE_BEGIN
     const int maxTileSize = (maxMemoryMB < 0) ? defaultMaxTileSize : INT_MAX;
     const size_t maxMemoryByteSize = (maxMemoryMB >= 0) ? size_t(maxMemoryMB)*1024*1024 : SIZE_MAX;
 
-    while ((tileCountH * tileCountW) % device->getNumSubdevices() != 0 ||
-           (tileH * tileW) > maxTileSize ||
-           !buildModel(maxMemoryByteSize))
+    // If the same configuration was committed before, use the cached tile plan instead of searching
+    // again. The plan may be invalid only if the user weights were updated in place, in which case
+    // we fall back to searching
+    PlanCache& planCache = device->getPlanCache();
+    const PlanKey planKey = getPlanKey(weightsBlob, weightsHash);
+    const TilePlan initTilePlan = getTilePlan();
+    TilePlan tilePlan;
+    bool tilePlanFound = planCache.find(planKey, tilePlan);
+    if (tilePlanFound)
     {
-      if (tileH > minTileH && tileH > tileW)
+      setTilePlan(tilePlan);
+      if (!buildModel(maxMemoryByteSize))
       {
-        const int newTileH = ceil_div(H + (2*tileOverlap+tilePadH) * tileCountH, tileCountH + 1);
-        tileH = clamp(round_up(newTileH, tileAlignment, tilePadH), minTileH, tileH - tileAlignment);
-        tileCountH = max(ceil_div(H - (2*tileOverlap+tilePadH), tileH - (2*tileOverlap+tilePadH)), 1);
+        setTilePlan(initTilePlan);
+        tilePlanFound = false;
       }
-      else if (tileW > minTileW)
-      {
-        const int newTileW = ceil_div(W + (2*tileOverlap+tilePadW) * tileCountW, tileCountW + 1);
-        tileW = clamp(round_up(newTileW, tileAlignment, tilePadW), minTileW, tileW - tileAlignment);
-        tileCountW = max(ceil_div(W - (2*tileOverlap+tilePadW), tileW - (2*tileOverlap+tilePadW)), 1);
-      }
-      else
+    }
+
+    while (!tilePlanFound &&
+           (getTileCount() < device->getNumStreamSubdevices() ||
+            (tileH * tileW * tileB) > maxTileSize ||
+            !buildModel(maxMemoryByteSize)))
+    {
+      if (!splitTile(minTileH, minTileW))
       {
         // Cannot divide further
         if (!buildModel())
@@ -325,22 +600,290 @@ OIDN_NAMESPACE_BEGIN
       }
     }
 
+    // Refine the tile plan by measuring the performance of smaller tiles, which may fit better in
+    // the caches of the device
+    if (!tilePlanFound && autotune)
+      tuneTilePlan(weightsHash, maxMemoryByteSize, minTileH, minTileW);
+
+    if (!tilePlanFound)
+      planCache.insert(planKey, getTilePlan());
+
     if (device->isVerbose(2))
     {
       std::cout << "Image size: " << W << "x" << H << std::endl;
       std::cout << "Tile size : " << tileW << "x" << tileH << std::endl;
       std::cout << "Tile count: " << tileCountW << "x" << tileCountH << std::endl;
+      std::cout << "Tile plan : " << (tilePlanFound ? "cached" : "new") << std::endl;
+      if (batchSize > 1)
+      {
+        std::cout << "Batch size: " << batchSize << std::endl;
+        std::cout << "Tile batch: " << tileB << "x" << tileCountB << std::endl;
+      }
       std::cout << "In-place  : " << (inplace ? "true" : "false") << std::endl;
+      if (!instances.empty() && instances[0].graph->isPipelined())
+        std::cout << "Pipelined : true" << std::endl;
     }
   }
 
+  PlanKey UNetFilter::getPlanKey(const Data& weightsBlob, uint64_t weightsHash) const
+  {
+    PlanKey key;
+    key.weightsHash = weightsHash;
+    key.weightsByteSize = weightsBlob.size;
+    key.H = output->getH();
+    key.W = output->getW();
+    key.batchSize = batchSize;
+    key.colorFormat  = color  ? color->getFormat()  : Format::Undefined;
+    key.albedoFormat = albedo ? albedo->getFormat() : Format::Undefined;
+    key.normalFormat = normal ? normal->getFormat() : Format::Undefined;
+    key.outputFormat = output->getFormat();
+    key.quality = quality;
+    key.precision = precision;
+    key.maxMemoryMB = maxMemoryMB;
+    key.hdr = hdr;
+    key.inplace = inplace;
+    key.autotune = autotune;
+    key.skipConstantTiles = tileSkipping;
+    return key;
+  }
+
+  TilePlan UNetFilter::getTilePlan() const
+  {
+    TilePlan plan;
+    plan.tileH = tileH;
+    plan.tileW = tileW;
+    plan.tileB = tileB;
+    plan.tileCountH = tileCountH;
+    plan.tileCountW = tileCountW;
+    plan.tileCountB = tileCountB;
+    return plan;
+  }
+
+  void UNetFilter::setTilePlan(const TilePlan& plan)
+  {
+    tileH = plan.tileH;
+    tileW = plan.tileW;
+    tileB = plan.tileB;
+    tileCountH = plan.tileCountH;
+    tileCountW = plan.tileCountW;
+    tileCountB = plan.tileCountB;
+  }
+
+  // Divides the image into more tiles, returns false if it cannot be divided further
+  bool UNetFilter::splitTile(int minTileH, int minTileW)
+  {
+    if (tileB > 1)
+    {
+      // Denoise fewer images together first
+      tileB = ceil_div(batchSize, tileCountB + 1);
+      tileCountB = ceil_div(batchSize, tileB);
+    }
+    else if (tileH > minTileH && tileH > tileW)
+    {
+      const int newTileH = ceil_div(H + (2*tileOverlap+tilePadH) * tileCountH, tileCountH + 1);
+      tileH = clamp(round_up(newTileH, tileAlignment, tilePadH), minTileH, tileH - tileAlignment);
+      tileCountH = max(ceil_div(H - (2*tileOverlap+tilePadH), tileH - (2*tileOverlap+tilePadH)), 1);
+    }
+    else if (tileW > minTileW)
+    {
+      const int newTileW = ceil_div(W + (2*tileOverlap+tilePadW) * tileCountW, tileCountW + 1);
+      tileW = clamp(round_up(newTileW, tileAlignment, tilePadW), minTileW, tileW - tileAlignment);
+      tileCountW = max(ceil_div(W - (2*tileOverlap+tilePadW), tileW - (2*tileOverlap+tilePadW)), 1);
+    }
+    else
+      return false;
+
+    return true;
+  }
+
+  // Selects the fastest tile plan among the current one (which must be already built) and the
+  // plans with 2^level times more tiles. The selected level is stored in the tuning cache of the
+  // device, so the measurements are done only once for similar configurations
+  void UNetFilter::tuneTilePlan(uint64_t weightsHash, size_t maxMemoryByteSize,
+                                int minTileH, int minTileW)
+  {
+    if (H <= 0 || W <= 0)
+      return;
+
+    TuningCache& tuningCache = device->getTuningCache();
+    const std::string tuningKey = getTuningKey(weightsHash);
+    const TilePlan basePlan = getTilePlan();
+    const int baseTileCount = getTileCount();
+
+    // Sets the tile plan of the specified level, returns false if the image cannot be divided into
+    // enough tiles
+    auto setTuningLevel = [&](int level)
+    {
+      setTilePlan(basePlan);
+      while (getTileCount() < (baseTileCount << level))
+      {
+        if (!splitTile(minTileH, minTileW))
+          return false;
+      }
+      return true;
+    };
+
+    int bestLevel = 0;
+    const bool tuned = tuningCache.find(tuningKey, bestLevel);
+
+    if (!tuned)
+    {
+      double bestTime = std::numeric_limits<double>::infinity();
+      int builtLevel = 0;
+
+      for (int level = 0; level <= maxTuningLevel; ++level)
+      {
+        if (level > 0)
+        {
+          resetModel();
+          builtLevel = -1;
+          if (!setTuningLevel(level))
+            break;
+          if (!buildModel(maxMemoryByteSize))
+            continue;
+          builtLevel = level;
+        }
+
+        const double time = measureTilePlan();
+        if (device->isVerbose(2))
+        {
+          std::cout << "Tuning    : level " << level << ", " << tileW << "x" << tileH << " tiles, "
+                    << time * 1000 << " msec" << std::endl;
+        }
+
+        if (time < bestTime)
+        {
+          bestTime = time;
+          bestLevel = level;
+        }
+      }
+
+      tuningCache.insert(tuningKey, bestLevel);
+
+      if (builtLevel == bestLevel)
+        return;
+      resetModel();
+    }
+    else
+    {
+      // The cached level is relative to the base plan, which is already built
+      if (bestLevel == 0)
+        return;
+      resetModel();
+    }
+
+    // Build the model with the selected plan, falling back to the base plan if the cached level
+    // is not applicable to this configuration (e.g. the image is slightly smaller)
+    if (!setTuningLevel(bestLevel) || !buildModel(maxMemoryByteSize))
+    {
+      resetModel();
+      setTilePlan(basePlan);
+      if (!buildModel())
+        throw std::runtime_error("could not build filter model");
+    }
+  }
+
+  // Returns the key of the configuration in the tuning cache, which identifies the device, the
+  // weights and the resolution class (the image dimensions rounded up to powers of two)
+  std::string UNetFilter::getTuningKey(uint64_t weightsHash) const
+  {
+    auto getSizeClass = [](int size)
+    {
+      int sizeClass = 0;
+      while ((1 << sizeClass) < size)
+        ++sizeClass;
+      return sizeClass;
+    };
+
+    std::stringstream sm;
+    sm << device->getType() << "-" << device->getNumStreamSubdevices()
+       << "-" << std::hex << weightsHash << std::dec
+       << "-" << getSizeClass(W) << "x" << getSizeClass(H) << "x" << batchSize
+       << "-q" << int(quality) << "p" << int(precision) << "m" << maxMemoryMB
+       << (hdr ? "h" : "") << (inplace ? "i" : "");
+    return sm.str();
+  }
+
+  // Measures the time of denoising the first tile, without writing the output, and returns the
+  // estimated time of denoising the whole image in seconds
+  double UNetFilter::measureTilePlan()
+  {
+    Instance& instance = instances[0];
+    Engine* engine = instance.graph->getEngine();
+    const TileDesc tile = getTileDesc(0);
+
+    // The input images may not be initialized yet at commit time, and e.g. NaNs or denormals could
+    // skew the measurements, so a zero-filled synthetic input of the same formats is denoised
+    auto newTuningSrc = [&](const Ref<Image>& image) -> Ref<Image>
+    {
+      if (!image)
+        return nullptr;
+      const ImageDesc desc(image->getFormat(), tile.W1, tile.H1 * tile.B);
+      auto buffer = engine->newBuffer(desc.getByteSize(), Storage::Device);
+      const std::vector<char> zeros(desc.getByteSize(), 0);
+      buffer->write(0, zeros.size(), zeros.data());
+      return buffer->newImage(desc);
+    };
+
+    instance.transferFunc->setInputScale(1);
+    instance.inputProcess->setSrc(newTuningSrc(color), newTuningSrc(albedo), newTuningSrc(normal));
+    instance.inputProcess->setTile(0, 0, tile.alignOffsetH, tile.alignOffsetW, tile.H1, tile.W1);
+    instance.inputProcess->setBatch(tile.B, tile.H1);
+
+    // The first run is for warm-up
+    double tileTime = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < numTuningRuns; ++i)
+    {
+      Timer timer;
+      instance.graph->submitWithoutOutput(nullptr);
+      instance.graph->getEngine()->wait();
+      if (i > 0)
+        tileTime = min(tileTime, timer.query());
+    }
+
+    // The tiles are distributed among the subdevices
+    return tileTime * ceil_div(getTileCount(), int(instances.size()));
+  }
+
+  UNetFilter::TileDesc UNetFilter::getTileDesc(int tileIndex) const
+  {
+    // The tiles are ordered by image, row and column
+    const int j = tileIndex % tileCountW;
+    const int i = (tileIndex / tileCountW) % tileCountH;
+    const int k = tileIndex / (tileCountW * tileCountH);
+
+    TileDesc tile;
+    tile.b = k * tileB;
+    tile.B = min(batchSize - tile.b, tileB);
+
+    tile.h = i * (tileH - (2*tileOverlap+tilePadH));
+    tile.overlapBeginH = i > 0 ? tileOverlap : 0;
+    const int overlapEndH = i < tileCountH-1 ? tileOverlap+tilePadH : 0; // overlap on the bottom
+    tile.H1 = min(H - tile.h, tileH);
+    tile.H2 = tile.H1 - tile.overlapBeginH - overlapEndH;
+    tile.alignOffsetH = tileH - round_up(tile.H1, minTileAlignment);
+
+    tile.w = j * (tileW - (2*tileOverlap+tilePadW));
+    tile.overlapBeginW = j > 0 ? tileOverlap : 0;
+    const int overlapEndW = j < tileCountW-1 ? tileOverlap+tilePadW : 0; // overlap on the right
+    tile.W1 = min(W - tile.w, tileW);
+    tile.W2 = tile.W1 - tile.overlapBeginW - overlapEndW;
+    tile.alignOffsetW = tileW - round_up(tile.W1, minTileAlignment);
+
+    return tile;
+  }
+
   void UNetFilter::cleanup()
   {
     instances.clear();
-    transferFunc.reset();
     autoexposure.reset();
+    autoexposureDsts.clear();
     imageCopy.reset();
     outputTemp.reset();
+    tileVariance.reset();
+    tileVarianceDsts.clear();
+    tilePassThrough.reset();
+    weightsFile.reset();
   }
 
   void UNetFilter::checkParams()
@@ -349,6 +892,8 @@ OIDN_NAMESPACE_BEGIN
       throw Exception(Error::InvalidOperation, "input image not specified");
     if (!output)
       throw Exception(Error::InvalidOperation, "output image not specified");
+    if (stream >= device->getNumStreams())
+      throw Exception(Error::InvalidArgument, "invalid filter stream");
 
     auto isSupportedFormat = [](Format format)
     {
@@ -374,6 +919,9 @@ OIDN_NAMESPACE_BEGIN
         (normal && (normal->getW() != output->getW() || normal->getH() != output->getH())))
       throw Exception(Error::InvalidOperation, "image size mismatch");
 
+    if (output->getH() % batchSize != 0)
+      throw Exception(Error::InvalidOperation, "image height is not a multiple of the batch size");
+
     if (directional && (hdr || srgb))
       throw Exception(Error::InvalidOperation, "directional and hdr/srgb modes cannot be enabled at the same time");
     if (hdr && srgb)
@@ -382,6 +930,8 @@ OIDN_NAMESPACE_BEGIN
     if (device->isVerbose(2))
     {
       std::cout << "Quality: " << quality << std::endl;
+      if (precision != Precision::Default)
+        std::cout << "Precision: " << precision << std::endl;
       std::cout << "Inputs:";
       if (color)  std::cout << " " << (directional ? "dir" : (hdr ? "hdr" : "ldr")) << ":" << color->getFormat();
       if (albedo) std::cout << " " << "alb" << ":" << albedo->getFormat();
@@ -442,6 +992,12 @@ OIDN_NAMESPACE_BEGIN
     {
       weightsBlob = userWeightsBlob;
     }
+    else if (userWeightsFile)
+    {
+      // Pre-reordered weights may be used in-place, so the file must stay mapped while in use
+      weightsFile = userWeightsFile;
+      weightsBlob = weightsFile->getData();
+    }
     else if (model)
     {
       switch (quality)
@@ -544,24 +1100,39 @@ OIDN_NAMESPACE_BEGIN
     if (normal) inputC += 3;
 
     // Create global operations (not part of any model instance or graph)
+    // The autoexposure is computed separately for each image in the batch
     Ref<Autoexposure> autoexposure;
     if (hdr)
-      autoexposure = device->getEngine()->newAutoexposure(color->getDesc());
+    {
+      ImageDesc autoexposureSrcDesc = color->getDesc();
+      autoexposureSrcDesc.height = H;
+      autoexposure = device->getStreamEngine(stream)->newAutoexposure(autoexposureSrcDesc);
+    }
+
+    // The variance of each tile is computed for finding the constant tiles
+    Ref<TileVariance> tileVariance;
+    if (tileSkipping)
+      tileVariance = device->getStreamEngine(stream)->newTileVariance();
 
     const bool snorm = directional || (!color && normal);
     TensorDims inputDims{inputC, tileH, tileW};
     size_t totalMemoryByteSize = 0;
 
     // Create model instances for each subdevice
-    for (int instanceID = 0; instanceID < device->getNumSubdevices(); ++instanceID)
+    for (int instanceID = 0; instanceID < device->getNumStreamSubdevices(); ++instanceID)
     {
       auto& instance = instances[instanceID];
       auto& graph = instance.graph;
 
+      // Pipeline the tiles if there are multiple tiles and a single model instance
+      if (device->getNumStreamSubdevices() == 1 && getTileCount() > 1 &&
+          graph->getEngine()->isConcurrencySupported())
+        graph->setPipelined(true);
+
       // Create the model graph
-      auto inputProcess = graph->addInputProcess("input", inputDims, transferFunc, hdr, snorm);
+      auto inputProcess = graph->addInputProcess("input", inputDims, tileB, instance.transferFunc, hdr, snorm);
       auto x = largeModel ? addUNetLarge(graph, inputProcess) : addUNet(graph, inputProcess);
-      auto outputProcess = graph->addOutputProcess("output", x, transferFunc, hdr, snorm);
+      auto outputProcess = graph->addOutputProcess("output", x, instance.transferFunc, hdr, snorm);
 
       // Check whether all operations in the graph are supported
       if (!graph->isSupported())
@@ -577,11 +1148,13 @@ OIDN_NAMESPACE_BEGIN
       // Allocate scratch for global operations
       if (instanceID == 0 && hdr)
         scratchByteSize = max(scratchByteSize, autoexposure->getScratchByteSize());
+      if (instanceID == 0 && tileSkipping)
+        scratchByteSize = max(scratchByteSize, tileVariance->getScratchByteSize());
 
       scratchByteSize = round_up(scratchByteSize, memoryAlignment);
 
       // If doing in-place _tiled_ filtering, allocate a temporary output image
-      ImageDesc outputTempDesc(output->getFormat(), W, H);
+      ImageDesc outputTempDesc(output->getFormat(), W, output->getH());
       size_t outputTempByteOffset = SIZE_MAX;
       if (instanceID == 0 && inplace && (tileCountH * tileCountW) > 1)
       {
@@ -589,19 +1162,27 @@ OIDN_NAMESPACE_BEGIN
         scratchByteSize += round_up(outputTempDesc.getByteSize(), memoryAlignment);
       }
 
-      // If denoising in HDR mode, allocate a tensor for the autoexposure result
+      // If denoising in HDR mode, allocate a tensor for the autoexposure results
       size_t autoexposureDstOffset = SIZE_MAX;
       if (instanceID == 0 && hdr)
       {
         autoexposureDstOffset = scratchByteSize;
-        scratchByteSize += round_up(sizeof(float), memoryAlignment);
+        scratchByteSize += round_up(sizeof(float) * batchSize, memoryAlignment);
+      }
+
+      // If skipping constant tiles, allocate a tensor for the tile variance results
+      size_t tileVarianceDstOffset = SIZE_MAX;
+      if (instanceID == 0 && tileSkipping)
+      {
+        tileVarianceDstOffset = scratchByteSize;
+        scratchByteSize += round_up(sizeof(float) * getTileCount(), memoryAlignment);
       }
 
       // Check the total memory usage
       if (instanceID == 0)
       {
         totalMemoryByteSize = (scratchByteSize + graph->getPrivateByteSize()) +
-          (graphScratchByteSize + graph->getPrivateByteSize()) * (device->getNumSubdevices() - 1);
+          (graphScratchByteSize + graph->getPrivateByteSize()) * (device->getNumStreamSubdevices() - 1);
 
         if (totalMemoryByteSize > maxMemoryByteSize)
         {
@@ -611,7 +1192,7 @@ OIDN_NAMESPACE_BEGIN
       }
 
       // Allocate the scratch buffer
-      auto scratchArena = device->getSubdevice(instanceID)->newScratchArena(scratchByteSize);
+      auto scratchArena = device->getStreamSubdevice(stream, instanceID)->newScratchArena(scratchByteSize);
       auto scratch = scratchArena->newBuffer(scratchByteSize);
 
       // Set the scratch buffer for the graph and the global operations
@@ -619,7 +1200,14 @@ OIDN_NAMESPACE_BEGIN
       if (instanceID == 0 && hdr)
       {
         autoexposure->setScratch(scratch);
-        autoexposure->setDst(makeRef<Record<float>>(scratch, autoexposureDstOffset));
+        for (int b = 0; b < batchSize; ++b)
+          autoexposureDsts.push_back(makeRef<Record<float>>(scratch, autoexposureDstOffset + sizeof(float) * b));
+      }
+      if (instanceID == 0 && tileSkipping)
+      {
+        tileVariance->setScratch(scratch);
+        for (int i = 0; i < getTileCount(); ++i)
+          tileVarianceDsts.push_back(makeRef<Record<float>>(scratch, tileVarianceDstOffset + sizeof(float) * i));
       }
 
       // Finalize the network
@@ -638,9 +1226,18 @@ OIDN_NAMESPACE_BEGIN
       autoexposure->finalize();
     this->autoexposure = autoexposure;
 
+    if (tileSkipping)
+    {
+      tileVariance->finalize();
+      this->tileVariance = tileVariance;
+      tilePassThrough = device->getStreamEngine(stream)->newTilePassThrough(
+        {instances[0].transferFunc, hdr, snorm});
+      tilePassThrough->finalize();
+    }
+
     if (outputTemp)
     {
-      imageCopy = device->getEngine()->newImageCopy();
+      imageCopy = device->getStreamEngine(stream)->newImageCopy();
       imageCopy->setSrc(outputTemp);
       imageCopy->finalize();
     }
@@ -662,8 +1259,12 @@ OIDN_NAMESPACE_BEGIN
     }
 
     autoexposure.reset();
+    autoexposureDsts.clear();
     imageCopy.reset();
     outputTemp.reset();
+    tileVariance.reset();
+    tileVarianceDsts.clear();
+    tilePassThrough.reset();
   }
 
 OIDN_NAMESPACE_END
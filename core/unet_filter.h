@@ -8,6 +8,9 @@
 #include "color.h"
 #include "autoexposure.h"
 #include "image_copy.h"
+#include "tile_variance.h"
+#include "tile_pass_through.h"
+#include "mapped_file.h"
 
 OIDN_NAMESPACE_BEGIN
 
@@ -22,6 +25,8 @@ OIDN_NAMESPACE_BEGIN
     int getInt(const std::string& name) override;
     void setFloat(const std::string& name, float value) override;
     float getFloat(const std::string& name) override;
+    void setString(const std::string& name, const std::string& value) override;
+    const char* getString(const std::string& name) override;
 
     void commit() override;
     void execute(SyncMode sync) override;
@@ -38,6 +43,10 @@ OIDN_NAMESPACE_BEGIN
 
     static constexpr int defaultMaxTileSize   = 2160*2160; // default maximum number of pixels per tile
 
+    // Autotuning constants
+    static constexpr int maxTuningLevel = 3; // maximum number of times the tile count is doubled
+    static constexpr int numTuningRuns  = 3; // number of measurements per tile plan (including warm-up)
+
     // Images
     Ref<Image> color;
     Ref<Image> albedo;
@@ -47,6 +56,7 @@ OIDN_NAMESPACE_BEGIN
     // Options
     static constexpr Quality defaultQuality = Quality::High;
     Quality quality = defaultQuality;
+    Precision precision = Precision::Default;
     bool hdr = false;
     bool srgb = false;
     bool directional = false;
@@ -54,6 +64,11 @@ OIDN_NAMESPACE_BEGIN
     bool cleanAux = false;
     int maxMemoryMB = -1;     // maximum memory usage limit in MBs, disabled if < 0
     int prevMaxMemoryMB = -1; // maximum memory usage limit in MBs from the previous commit
+    int batchSize = 1;        // number of images stacked vertically in the input/output images
+    int stream = 0;           // stream of the device to execute on
+    bool autotune = false;    // select the tile size by measuring the performance of candidates
+    bool skipConstantTiles = false;   // pass through the tiles with input variance below the threshold
+    float constantTileThreshold = 0;  // maximum input variance of the passed through tiles
 
     struct Model
     {
@@ -83,6 +98,7 @@ OIDN_NAMESPACE_BEGIN
       Model nrm;
     } models; // built-in weights blobs
     Data userWeightsBlob;
+    std::shared_ptr<MappedFile> userWeightsFile; // memory-mapped user weights file
 
   private:
     void init();
@@ -93,36 +109,72 @@ OIDN_NAMESPACE_BEGIN
     Ref<Op> addUNetLarge(const Ref<Graph>& graph, const Ref<Op>& inputProcess);
     bool buildModel(size_t maxMemoryByteSize = std::numeric_limits<size_t>::max());
     void resetModel();
+    PlanKey getPlanKey(const Data& weightsBlob, uint64_t weightsHash) const;
+    TilePlan getTilePlan() const;
+    void setTilePlan(const TilePlan& plan);
+    bool splitTile(int minTileH, int minTileW);
+    void tuneTilePlan(uint64_t weightsHash, size_t maxMemoryByteSize, int minTileH, int minTileW);
+    std::string getTuningKey(uint64_t weightsHash) const;
+    double measureTilePlan();
 
     // Image dimensions
-    int H = 0;             // image height
+    int H = 0;             // image height (of a single image in the batch)
     int W = 0;             // image width
     int tileH = 0;         // tile height
     int tileW = 0;         // tile width
+    int tileB = 1;         // tile size in the batch dimension (number of images denoised together)
     int tilePadH = 0;      // tile padding in H dimension (may be required for alignment)
     int tilePadW = 0;      // tile padding in W dimension (may be required for alignment)
     int tileCountH = 1;    // number of tiles in H dimension
     int tileCountW = 1;    // number of tiles in W dimension
+    int tileCountB = 1;    // number of tiles in the batch dimension
     int tileOverlap = 0;   // device-dependent spatial overlap between tiles in pixels
     int tileAlignment = 1; // device-dependent spatial tile offset alignment in pixels
     bool inplace = false;  // indicates whether input and output buffers overlap
+    bool tileSkipping = false; // skip constant tiles (if supported by the device)
+    int skippedTileCount = 0;  // number of tiles skipped in the last execution
+
+    // Position and size of a tile in the image
+    struct TileDesc
+    {
+      int b;             // first image of the tile in the batch
+      int B;             // number of images in the tile
+      int h, w;          // input tile position (including overlaps)
+      int H1, W1;        // input tile size (including overlaps)
+      int H2, W2;        // output tile size
+      int overlapBeginH; // overlap on the top
+      int overlapBeginW; // overlap on the left
+      int alignOffsetH;  // offset of the input in the tile buffer (aligned to the bottom)
+      int alignOffsetW;  // offset of the input in the tile buffer (aligned to the right)
+    };
+
+    int getTileCount() const { return tileCountH * tileCountW * tileCountB; }
+    TileDesc getTileDesc(int tileIndex) const;
 
     // Per-engine model instance
+    // Each instance has its own transfer function because the instances may be submitted to
+    // concurrently with different input scales
     struct Instance
     {
       Ref<Graph> graph;
+      std::shared_ptr<TransferFunction> transferFunc;
       Ref<InputProcess> inputProcess;
       Ref<OutputProcess> outputProcess;
     };
 
     // Model
     std::vector<Instance> instances;
-    std::shared_ptr<TransferFunction> transferFunc;
     Ref<Autoexposure> autoexposure;
+    std::vector<Ref<Record<float>>> autoexposureDsts; // autoexposure result for each image
     // In-place tiled filtering
     Ref<ImageCopy> imageCopy;
     Ref<Image> outputTemp;
+    // Skipping constant tiles
+    Ref<TileVariance> tileVariance;
+    std::vector<Ref<Record<float>>> tileVarianceDsts; // tile variance result for each tile
+    Ref<TilePassThrough> tilePassThrough; // copies the input of the skipped tiles to the output
     bool largeModel = false; // is UNetLarge?
+    std::shared_ptr<MappedFile> weightsFile; // mapped weights file referenced by the model
   };
 
 OIDN_NAMESPACE_END
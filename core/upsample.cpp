@@ -34,4 +34,11 @@ OIDN_NAMESPACE_BEGIN
     updateDst();
   }
 
+  bool Upsample::getAccesses(std::vector<MemoryAccess>& accesses) const
+  {
+    addAccess(accesses, src, false);
+    addAccess(accesses, dst, true);
+    return true;
+  }
+
 OIDN_NAMESPACE_END
@@ -25,6 +25,8 @@ OIDN_NAMESPACE_BEGIN
     void setSrc(const Ref<Tensor>& src);
     void setDst(const Ref<Tensor>& dst);
 
+    bool getAccesses(std::vector<MemoryAccess>& accesses) const override;
+
   protected:
     virtual void updateSrc() {}
     virtual void updateDst() {}
@@ -0,0 +1,82 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "weights_cache.h"
+#include <cstring>
+
+OIDN_NAMESPACE_BEGIN
+
+  // Processes 8 bytes at a time
+  uint64_t getDataHash(const void* ptr, size_t byteSize)
+  {
+    const uint8_t* bytes = static_cast<const uint8_t*>(ptr);
+    uint64_t hash = 0xcbf29ce484222325ull ^ byteSize;
+
+    auto combine = [&](uint64_t value)
+    {
+      value *= 0xff51afd7ed558ccdull;
+      value ^= value >> 33;
+      hash = (hash ^ value) * 0x100000001b3ull;
+    };
+
+    size_t i = 0;
+    for (; i + 8 <= byteSize; i += 8)
+    {
+      uint64_t value;
+      std::memcpy(&value, bytes + i, 8);
+      combine(value);
+    }
+
+    if (i < byteSize)
+    {
+      uint64_t value = 0;
+      std::memcpy(&value, bytes + i, byteSize - i);
+      combine(value);
+    }
+
+    hash ^= hash >> 32;
+    return hash;
+  }
+
+  std::shared_ptr<TensorMap> WeightsCache::get(const Data& weights, uint64_t hash)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+    {
+      // The hash is not collision-resistant, so the contents must be compared too
+      if (it->hash == hash && it->weights.size() == weights.size &&
+          std::memcmp(it->weights.data(), weights.ptr, weights.size) == 0)
+      {
+        // Move the entry to the front of the list
+        entries.splice(entries.begin(), entries, it);
+        numHits++;
+        std::shared_ptr<TensorMap> tensors = it->tensors;
+        evict();
+        return tensors;
+      }
+    }
+
+    std::shared_ptr<TensorMap> tensors = std::make_shared<TensorMap>();
+    const char* weightsPtr = static_cast<const char*>(weights.ptr);
+    entries.push_front({hash, std::vector<char>(weightsPtr, weightsPtr + weights.size), tensors});
+    numMisses++;
+    evict();
+    return tensors;
+  }
+
+  void WeightsCache::evict()
+  {
+    // Entries still referenced by graphs are never evicted because their tensors could not be
+    // freed anyway
+    size_t numUnused = 0;
+    for (auto it = entries.begin(); it != entries.end(); )
+    {
+      if (it->tensors.use_count() == 1 && ++numUnused > capacity)
+        it = entries.erase(it);
+      else
+        ++it;
+    }
+  }
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,53 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "tensor.h"
+#include "exception.h"
+#include "data.h"
+#include <list>
+#include <vector>
+#include <mutex>
+
+OIDN_NAMESPACE_BEGIN
+
+  // Computes a 64-bit hash of the contents of a memory region
+  uint64_t getDataHash(const void* ptr, size_t byteSize);
+
+  // Cache of the final (e.g. reordered) weights of the filters on a subdevice. The weights are
+  // identified by their contents, thus filters with the same built-in or user weights share a
+  // single copy of the final tensors. Entries are referenced by the graphs using them, and the
+  // least recently used unreferenced entries are evicted if their number exceeds the capacity
+  class WeightsCache final
+  {
+  public:
+    static constexpr size_t defaultCapacity = 4;
+
+    explicit WeightsCache(size_t capacity = defaultCapacity) : capacity(capacity) {}
+
+    // Returns the cached tensors of the specified weights blob with the specified hash (computed by
+    // getDataHash), and updates the hit/miss counters
+    std::shared_ptr<TensorMap> get(const Data& weights, uint64_t hash);
+
+    int getNumHits() const { return numHits; }
+    int getNumMisses() const { return numMisses; }
+
+  private:
+    struct Entry
+    {
+      uint64_t hash;
+      std::vector<char> weights; // copy of the weights blob for comparing the contents on a hash match
+      std::shared_ptr<TensorMap> tensors;
+    };
+
+    void evict();
+
+    size_t capacity;
+    std::list<Entry> entries; // most recently used first
+    int numHits = 0;
+    int numMisses = 0;
+    std::mutex mutex;
+  };
+
+OIDN_NAMESPACE_END
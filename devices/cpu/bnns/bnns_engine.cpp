@@ -7,8 +7,8 @@
 
 OIDN_NAMESPACE_BEGIN
 
-  BNNSEngine::BNNSEngine(CPUDevice* device, int numThreads)
-    : CPUEngine(device, numThreads)
+  BNNSEngine::BNNSEngine(CPUDevice* device, int numThreads, int stream, int numStreams)
+    : CPUEngine(device, numThreads, -1, stream, numStreams)
   {}
 
   Ref<Conv> BNNSEngine::newConv(const ConvDesc& desc)
@@ -10,7 +10,7 @@ OIDN_NAMESPACE_BEGIN
   class BNNSEngine final : public CPUEngine
   {
   public:
-    BNNSEngine(CPUDevice* device, int numThreads);
+    BNNSEngine(CPUDevice* device, int numThreads, int stream = 0, int numStreams = 1);
 
     // Ops
     Ref<Conv> newConv(const ConvDesc& desc) override;
@@ -0,0 +1,385 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "cpu_amx_conv.h"
+#include <immintrin.h>
+
+// The AMX code is compiled only for the kernel functions, so the rest of the module can still
+// run on CPUs without AMX
+#if defined(_MSC_VER) && !defined(__clang__)
+  #define OIDN_AMX_TARGET
+#else
+  #define OIDN_AMX_TARGET __attribute__((target("avx512f,avx512bw,avx512vl,f16c,amx-tile,amx-bf16")))
+#endif
+
+OIDN_NAMESPACE_BEGIN
+
+  namespace
+  {
+    constexpr int blockC   = 16;  // channels per block, which is also the K and N of the tiles
+    constexpr int tileM    = 16;  // pixels per tile
+    constexpr int blockOW  = 32;  // output pixels per block (2 tiles)
+    constexpr int taskOH   = 4;   // output rows per task, sharing the converted source rows
+    constexpr int taskOW   = 256; // output pixels per task
+
+    // Size of the FP32 accumulators of a block of pixels for 2 output channel blocks
+    constexpr size_t accumByteSize = 2 * blockOW * blockC * sizeof(float);
+
+    // Tile configuration (palette 1)
+    struct alignas(64) AMXTileConfig
+    {
+      uint8_t  palette;
+      uint8_t  startRow;
+      uint8_t  reserved[14];
+      uint16_t colsb[16];
+      uint8_t  rows[16];
+    };
+
+    struct AMXConvKernel
+    {
+      const uint8_t* src;
+      const uint8_t* src2;  // channels concatenated to the source (optional)
+      const uint8_t* weight;
+      const float* bias;
+      uint8_t* dst;
+
+      size_t srcCByteStride;
+      size_t srcHByteStride;
+      size_t src2CByteStride;
+      size_t src2HByteStride;
+      size_t dstCByteStride;
+      size_t dstHByteStride;
+      size_t pixelByteSize; // 16 channels of a source/destination pixel
+      size_t weightOByteStride;
+      size_t weightIByteStride;
+      size_t weightHByteStride;
+      size_t weightWByteStride;
+
+      int ICB;    // number of input channel blocks
+      int srcICB; // number of input channel blocks in the first source
+      int OCB;    // number of output channel blocks
+      int W;
+      int batchH; // height of each image in the batch
+      bool half;  // FP16 sources/destination
+      bool relu;
+      bool upsampleSrc; // the first source is stored at half resolution (nearest upsampling)
+    };
+
+    // Tiles 0-3 are the accumulators of 2 output channel blocks for 2 x 16 pixels (FP32), tiles
+    // 4-5 are 2 x 16 pixels of an input channel block (BF16), and tiles 6-7 are the weights of 2
+    // output channel blocks, with pairs of input channels interleaved in each row (BF16)
+    OIDN_AMX_TARGET void loadTileConfig()
+    {
+      AMXTileConfig config = {};
+      config.palette = 1;
+      for (int i = 0; i < 4; ++i)
+      {
+        config.rows[i]  = tileM;
+        config.colsb[i] = blockC * sizeof(float);
+      }
+      for (int i = 4; i < 6; ++i)
+      {
+        config.rows[i]  = tileM;
+        config.colsb[i] = blockC * sizeof(uint16_t);
+      }
+      for (int i = 6; i < 8; ++i)
+      {
+        config.rows[i]  = blockC / 2;
+        config.colsb[i] = blockC * 2 * sizeof(uint16_t);
+      }
+      _tile_loadconfig(&config);
+    }
+
+    OIDN_AMX_TARGET inline __m512 loadPixel(const uint8_t* ptr, bool half)
+    {
+      if (half)
+        return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)));
+      else
+        return _mm512_loadu_ps(ptr);
+    }
+
+    OIDN_AMX_TARGET inline void storePixel(uint8_t* ptr, __m512 value, bool half)
+    {
+      if (half)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr),
+                            _mm512_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+      else
+        _mm512_storeu_ps(ptr, value);
+    }
+
+    // Converts FP32 values to BF16 with rounding to nearest even (the values must not be NaN)
+    OIDN_AMX_TARGET inline __m256i convertToBF16(__m512 value)
+    {
+      const __m512i x   = _mm512_castps_si512(value);
+      const __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(x, 16), _mm512_set1_epi32(1));
+      const __m512i y   = _mm512_add_epi32(x, _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7fff)));
+      return _mm512_cvtepi32_epi16(_mm512_srli_epi32(y, 16));
+    }
+
+    // Converts the source pixels of a block of output pixels in rows [ohBegin, ohEnd), which must
+    // be in the same image, to BF16, including the zero padding. For each source row and input
+    // channel block, the buffer contains blockOW+2 consecutive pixels, so the source tile of each
+    // kernel column starts at a different pixel. An upsampled first source is read at (ih/2, iw/2)
+    OIDN_AMX_TARGET void packSrc(const AMXConvKernel& k, int ohBegin, int ohEnd, int owBegin,
+                                 __m256i* buf)
+    {
+      const int bhBegin = ohBegin % k.batchH; // row in the image
+
+      for (int r = 0; r < ohEnd - ohBegin + 2; ++r)
+      {
+        const int ih = bhBegin + r - 1;
+        for (int icb = 0; icb < k.ICB; ++icb)
+        {
+          __m256i* bufRow = buf + (r * k.ICB + icb) * (blockOW + 2);
+
+          if (ih < 0 || ih >= k.batchH)
+          {
+            for (int x = 0; x < blockOW + 2; ++x)
+              _mm256_store_si256(bufRow + x, _mm256_setzero_si256());
+            continue;
+          }
+
+          const int shift = (k.upsampleSrc && icb < k.srcICB) ? 1 : 0; // coordinate shift
+          const uint8_t* srcRow = (icb < k.srcICB)
+            ? k.src  + icb * k.srcCByteStride + size_t((ohBegin + r - 1) >> shift) * k.srcHByteStride
+            : k.src2 + (icb - k.srcICB) * k.src2CByteStride + size_t(ohBegin + r - 1) * k.src2HByteStride;
+          for (int x = 0; x < blockOW + 2; ++x)
+          {
+            const int iw = owBegin + x - 1;
+            if (iw >= 0 && iw < k.W)
+            {
+              const __m512 value = loadPixel(srcRow + (iw >> shift) * k.pixelByteSize, k.half);
+              _mm256_store_si256(bufRow + x, convertToBF16(value));
+            }
+            else
+              _mm256_store_si256(bufRow + x, _mm256_setzero_si256());
+          }
+        }
+      }
+    }
+
+    // Computes the accumulators of a block of output pixels for 1 or 2 output channel blocks,
+    // reading the 3 source rows starting at the specified row of the buffer
+    template<int numOCB>
+    OIDN_AMX_TARGET void computeBlock(const AMXConvKernel& k, const __m256i* srcBuf, int ocb,
+                                      float* accum)
+    {
+      _tile_zero(0);
+      _tile_zero(1);
+      if (numOCB == 2)
+      {
+        _tile_zero(2);
+        _tile_zero(3);
+      }
+
+      const uint8_t* weightPtr = k.weight + ocb * k.weightOByteStride;
+      const size_t srcStride = blockC * sizeof(uint16_t);
+      const size_t weightStride = blockC * 2 * sizeof(uint16_t);
+
+      for (int icb = 0; icb < k.ICB; ++icb)
+      {
+        for (int kh = 0; kh < 3; ++kh)
+        {
+          const __m256i* srcRow = srcBuf + (kh * k.ICB + icb) * (blockOW + 2);
+          const uint8_t* weightRow = weightPtr + icb * k.weightIByteStride + kh * k.weightHByteStride;
+
+          for (int kw = 0; kw < 3; ++kw)
+          {
+            _tile_loadd(4, srcRow + kw, srcStride);
+            _tile_loadd(5, srcRow + kw + tileM, srcStride);
+            _tile_loadd(6, weightRow + kw * k.weightWByteStride, weightStride);
+            _tile_dpbf16ps(0, 4, 6);
+            _tile_dpbf16ps(1, 5, 6);
+
+            if (numOCB == 2)
+            {
+              _tile_loadd(7, weightRow + k.weightOByteStride + kw * k.weightWByteStride, weightStride);
+              _tile_dpbf16ps(2, 4, 7);
+              _tile_dpbf16ps(3, 5, 7);
+            }
+          }
+        }
+      }
+
+      const size_t accumStride = blockC * sizeof(float);
+      _tile_stored(0, accum, accumStride);
+      _tile_stored(1, accum + tileM * blockC, accumStride);
+      if (numOCB == 2)
+      {
+        _tile_stored(2, accum + 2 * tileM * blockC, accumStride);
+        _tile_stored(3, accum + 3 * tileM * blockC, accumStride);
+      }
+    }
+
+    // Adds the bias to the accumulators, applies the activation, and stores the output pixels
+    OIDN_AMX_TARGET void storeBlock(const AMXConvKernel& k, const float* accum, int numOCB, int ocb,
+                                    int oh, int owBegin, int owEnd)
+    {
+      for (int i = 0; i < numOCB; ++i)
+      {
+        const __m512 bias = _mm512_loadu_ps(k.bias + (ocb + i) * blockC);
+        uint8_t* dstRow = k.dst + (ocb + i) * k.dstCByteStride + size_t(oh) * k.dstHByteStride;
+
+        for (int ow = owBegin; ow < owEnd; ++ow)
+        {
+          __m512 value = _mm512_load_ps(accum + (i * blockOW + ow - owBegin) * blockC);
+          value = _mm512_add_ps(value, bias);
+          if (k.relu)
+            value = _mm512_max_ps(value, _mm512_setzero_ps());
+          storePixel(dstRow + ow * k.pixelByteSize, value, k.half);
+        }
+      }
+    }
+
+    OIDN_AMX_TARGET void runAMXConv(const AMXConvKernel& k, uint8_t* scratch,
+                                    int ohBegin, int ohEnd, int owBegin, int owEnd)
+    {
+      float* accum = reinterpret_cast<float*>(scratch);
+      __m256i* srcBuf = reinterpret_cast<__m256i*>(scratch + accumByteSize);
+      const int srcBufRowSize = k.ICB * (blockOW + 2);
+
+      loadTileConfig();
+
+      for (int ow = owBegin; ow < owEnd; ow += blockOW)
+      {
+        const int owBlockEnd = min(ow + blockOW, owEnd);
+
+        // Convert the source rows once for the rows of each image in the range
+        for (int ohSegBegin = ohBegin; ohSegBegin < ohEnd; )
+        {
+          const int ohSegEnd = min((ohSegBegin / k.batchH + 1) * k.batchH, ohEnd);
+          packSrc(k, ohSegBegin, ohSegEnd, ow, srcBuf);
+
+          for (int oh = ohSegBegin; oh < ohSegEnd; ++oh)
+          {
+            const __m256i* srcBufRows = srcBuf + (oh - ohSegBegin) * srcBufRowSize;
+
+            int ocb = 0;
+            for (; ocb + 1 < k.OCB; ocb += 2)
+            {
+              computeBlock<2>(k, srcBufRows, ocb, accum);
+              storeBlock(k, accum, 2, ocb, oh, ow, owBlockEnd);
+            }
+            if (ocb < k.OCB)
+            {
+              computeBlock<1>(k, srcBufRows, ocb, accum);
+              storeBlock(k, accum, 1, ocb, oh, ow, owBlockEnd);
+            }
+          }
+
+          ohSegBegin = ohSegEnd;
+        }
+      }
+
+      _tile_release();
+    }
+  }
+
+  CPUAMXConv::CPUAMXConv(CPUEngine* engine, const ConvDesc& desc)
+    : Conv(desc),
+      engine(engine)
+  {
+    if (srcDesc.layout != TensorLayout::Chw16c ||
+        (srcDesc.dataType != DataType::Float32 && srcDesc.dataType != DataType::Float16))
+      throw std::invalid_argument("unsupported convolution source layout/data type");
+    if (weightDesc.getW() != 3 || weightDesc.getH() != 3)
+      throw std::invalid_argument("unsupported convolution kernel size");
+    if (weightDesc.layout != TensorLayout::IOhw16i16o || weightDesc.dataType != DataType::Float32)
+      throw std::invalid_argument("unsupported convolution weight layout/data type");
+    if (biasDesc.layout != TensorLayout::x || biasDesc.dataType != DataType::Float32)
+      throw std::invalid_argument("unsupported convolution bias layout/data type");
+    if (postOp != PostOp::None)
+      throw std::invalid_argument("unsupported convolution postop");
+    if (processDst)
+      throw std::invalid_argument("convolution destination processing is not supported");
+
+    // The weights are stored in BF16 with pairs of input channels interleaved, in the same layout
+    // as the weight tiles
+    weightDesc = {{weightDesc.getO(),       weightDesc.getI(),       3, 3},
+                  {weightDesc.getPaddedO(), weightDesc.getPaddedI(), 3, 3},
+                  TensorLayout::OIhw8i16o2i,
+                  DataType::BFloat16};
+
+    const int ICB = srcDesc.getPaddedC() / blockC;
+    const size_t srcBufByteSize = size_t((taskOH + 2) * ICB * (blockOW + 2)) * blockC * sizeof(uint16_t);
+    threadScratchByteSize = round_up(accumByteSize + srcBufByteSize, memoryAlignment);
+  }
+
+  size_t CPUAMXConv::getScratchByteSize()
+  {
+    return threadScratchByteSize * engine->getNumThreads();
+  }
+
+  void CPUAMXConv::setScratch(const Ref<Buffer>& scratch)
+  {
+    if (scratch->getByteSize() < getScratchByteSize())
+      throw std::invalid_argument("convolution scratch buffer is too small");
+    this->scratch = scratch;
+  }
+
+  void CPUAMXConv::submitKernels(const Ref<CancellationToken>& ct)
+  {
+    auto func = getBandFunc();
+    const int OH = dstDesc.getH();
+
+    engine->submitFunc([=] { func(0, OH); }, ct);
+  }
+
+  std::function<void(int hBegin, int hEnd)> CPUAMXConv::getBandFunc()
+  {
+    if (!src || !dst)
+      throw std::logic_error("convolution source/destination not set");
+    if (!scratch)
+      throw std::logic_error("convolution scratch not set");
+
+    const TensorByteOffset<bfloat16, TensorLayout::OIhw8i16o2i> weightOffset{
+      weight->getPaddedO(), weight->getPaddedI(), weight->getH(), weight->getW()};
+
+    AMXConvKernel kernel;
+    kernel.src    = static_cast<const uint8_t*>(src->getPtr());
+    kernel.src2   = src2 ? static_cast<const uint8_t*>(src2->getPtr()) : nullptr;
+    kernel.weight = static_cast<const uint8_t*>(weight->getPtr());
+    kernel.bias   = static_cast<const float*>(bias->getPtr());
+    kernel.dst    = static_cast<uint8_t*>(dst->getPtr());
+    kernel.half   = srcDesc.dataType == DataType::Float16;
+    kernel.pixelByteSize  = blockC * getDataTypeSize(srcDesc.dataType);
+    kernel.srcHByteStride = size_t(src->getW()) * kernel.pixelByteSize;
+    kernel.srcCByteStride = size_t(src->getH()) * kernel.srcHByteStride;
+    kernel.src2HByteStride = src2 ? size_t(src2->getW()) * kernel.pixelByteSize : 0;
+    kernel.src2CByteStride = src2 ? size_t(src2->getH()) * kernel.src2HByteStride : 0;
+    kernel.dstHByteStride = size_t(dst->getW()) * kernel.pixelByteSize;
+    kernel.dstCByteStride = size_t(dst->getH()) * kernel.dstHByteStride;
+    kernel.weightOByteStride = weightOffset(blockC, 0, 0, 0);
+    kernel.weightIByteStride = weightOffset(0, blockC, 0, 0);
+    kernel.weightHByteStride = weightOffset(0, 0, 1, 0);
+    kernel.weightWByteStride = weightOffset(0, 0, 0, 1);
+    kernel.ICB    = srcDesc.getPaddedC() / blockC;
+    kernel.srcICB = src->getPaddedC() / blockC;
+    kernel.OCB    = dst->getPaddedC() / blockC;
+    kernel.W      = dst->getW();
+    kernel.batchH = dst->getH() / batchSize;
+    kernel.relu   = activation == Activation::ReLU;
+    kernel.upsampleSrc = upsampleSrc;
+
+    uint8_t* scratchPtr = static_cast<uint8_t*>(scratch->getPtr());
+    const size_t threadScratchByteSize = this->threadScratchByteSize;
+
+    return [=](int ohBegin, int ohEnd)
+    {
+      const int OW  = kernel.W;
+      const int OHT = ceil_div(ohEnd - ohBegin, taskOH);
+      const int OWT = ceil_div(OW, taskOW);
+
+      parallel_for(OHT, OWT, [&](int oht, int owt)
+      {
+        const int threadIndex = tbb::this_task_arena::current_thread_index();
+        uint8_t* threadScratchPtr = scratchPtr + size_t(threadIndex) * threadScratchByteSize;
+
+        const int ohTaskBegin = ohBegin + oht * taskOH;
+        runAMXConv(kernel, threadScratchPtr, ohTaskBegin, min(ohTaskBegin + taskOH, ohEnd),
+                   owt * taskOW, min((owt + 1) * taskOW, OW));
+      });
+    };
+  }
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,50 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/conv.h"
+#include "cpu_engine.h"
+#include "cpu_band_op.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  // 3x3 convolution using AMX tiles, which multiplies BF16 sources and weights with FP32
+  // accumulation. The sources are converted to BF16 on the fly, which is slightly less accurate
+  // than the FP32 convolutions, so it is used only if fast math is enabled
+  class CPUAMXConv final : public Conv, public CPUBandOp
+  {
+  public:
+    CPUAMXConv(CPUEngine* engine, const ConvDesc& desc);
+
+    Engine* getEngine() const override { return engine; }
+    bool isSrc2Supported() const override { return engine->isConcatFusionEnabled(); }
+
+    size_t getScratchByteSize() override;
+    void setScratch(const Ref<Buffer>& scratch) override;
+
+    bool getAccesses(std::vector<MemoryAccess>& accesses) const override
+    {
+      // Only the op scratch at the beginning of the scratch buffer is used (the graph may store
+      // tensors after it)
+      if (scratch)
+      {
+        const size_t opScratchByteSize = threadScratchByteSize * engine->getNumThreads();
+        addAccess(accesses, scratch->getPtr(), opScratchByteSize, true);
+      }
+      return Conv::getAccesses(accesses);
+    }
+
+    void submitKernels(const Ref<CancellationToken>& ct) override;
+
+    TensorDesc getBandDstDesc() const override { return dstDesc; }
+    int getBandSrcH(int H) const override { return upsampleSrc ? ceil_div(H + 1, 2) : H + 1; } // KH = 3
+    std::function<void(int hBegin, int hEnd)> getBandFunc() override;
+
+  private:
+    CPUEngine* engine;
+    size_t threadScratchByteSize; // scratch size per thread
+    Ref<Buffer> scratch;
+  };
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,30 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/tensor.h"
+#include <functional>
+
+OIDN_NAMESPACE_BEGIN
+
+  // Interface for CPU ops whose output can be computed in bands of rows, which enables depth-first
+  // execution of op chains: the rows produced by an op are consumed by the next op while they are
+  // still in the cache
+  class CPUBandOp
+  {
+  public:
+    virtual ~CPUBandOp() = default;
+
+    // Returns the descriptor of the output tensor
+    virtual TensorDesc getBandDstDesc() const = 0;
+
+    // Returns the number of source rows required to compute the first H rows of the output
+    // (may exceed the height of the source)
+    virtual int getBandSrcH(int H) const = 0;
+
+    // Returns a function which computes the output rows in [hBegin, hEnd) using all threads
+    virtual std::function<void(int hBegin, int hEnd)> getBandFunc() = 0;
+  };
+
+OIDN_NAMESPACE_END
@@ -78,7 +78,9 @@ OIDN_NAMESPACE_BEGIN
 
   Tensor::operator ispc::TensorAccessor4D()
   {
-    if (getRank() != 4 || (layout != TensorLayout::IOhw8i8o && layout != TensorLayout::IOhw16i16o))
+    if (getRank() != 4 || (layout != TensorLayout::IOhw8i8o   && layout != TensorLayout::IOhw16i16o  &&
+                           layout != TensorLayout::WIOhw8i8o  && layout != TensorLayout::WIOhw16i16o &&
+                           layout != TensorLayout::IOhw2i8o4i && layout != TensorLayout::IOhw4i16o4i))
       throw std::logic_error("incompatible tensor accessor");
 
     ispc::TensorAccessor4D acc;
@@ -101,6 +103,20 @@ OIDN_NAMESPACE_BEGIN
   }
 #endif
 
+  ispc::DataType toISPC(DataType dataType)
+  {
+    switch (dataType)
+    {
+    case DataType::Void:    return ispc::DataType_Void;
+    case DataType::UInt8:   return ispc::DataType_UInt8;
+    case DataType::Float16: return ispc::DataType_Float16;
+    case DataType::Float32: return ispc::DataType_Float32;
+    case DataType::Int8:    return ispc::DataType_Int8;
+    default:
+      throw std::logic_error("unsupported data type");
+    }
+  }
+
   ispc::Tile toISPC(const Tile& tile)
   {
     ispc::Tile res;
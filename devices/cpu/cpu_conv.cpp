@@ -4,6 +4,7 @@
 #include "cpu_conv.h"
 #include "cpu_conv_ispc.h"
 #include "cpu_common.h"
+#include "cpu_output_process.h"
 
 OIDN_NAMESPACE_BEGIN
 
@@ -12,7 +13,8 @@ OIDN_NAMESPACE_BEGIN
       engine(engine)
   {
     if ((srcDesc.layout != TensorLayout::Chw8c &&
-         srcDesc.layout != TensorLayout::Chw16c) || srcDesc.dataType != DataType::Float32)
+         srcDesc.layout != TensorLayout::Chw16c) ||
+        (srcDesc.dataType != DataType::Float32 && srcDesc.dataType != DataType::Float16))
       throw std::invalid_argument("unsupported convolution source layout/data type");
     if (weightDesc.getW() != 3 || weightDesc.getH() != 3)
       throw std::invalid_argument("unsupported convolution kernel size");
@@ -21,28 +23,70 @@ OIDN_NAMESPACE_BEGIN
       throw std::invalid_argument("unsupported convolution weight layout/data type");
     if (biasDesc.layout != TensorLayout::x || biasDesc.dataType != DataType::Float32)
       throw std::invalid_argument("unsupported convolution bias layout/data type");
+    if (postOp != PostOp::None && postOp != PostOp::Pool)
+      throw std::invalid_argument("unsupported convolution postop");
 
     const int blockC = getTensorLayoutInfo(dstDesc.layout).blockC;
     const int IC = srcDesc.getPaddedC();
     const int OC = dstDesc.getPaddedC();
-    const int OH = dstDesc.getH();
-    const int OW = dstDesc.getW();
+    const int OH = srcDesc.getH(); // the output size before pooling is the same as the source size
+    const int OW = srcDesc.getW();
+
+    const CPUCacheSizes& cacheSizes = engine->getCacheSizes();
+    const size_t srcElemByteSize = getDataTypeSize(srcDesc.dataType);
+    const size_t dstElemByteSize = getDataTypeSize(dstDesc.dataType);
+    const size_t weightBlockByteSize = // weights for a block of input and output channels
+      size_t(weightDesc.getH()) * weightDesc.getW() * blockC * blockC * sizeof(float);
 
-    const int OCB = OC / blockC;
+    // Block the output channels as much as supported by the kernel, but the weights for a block of
+    // input channels should fit into the L1 cache
+    // With output processing, only the first output channel block is computed, which must contain
+    // all the output channels
+    if (processDst && weightDesc.getO() > blockC)
+      throw std::invalid_argument("unsupported convolution destination processing");
+    const int OCB = processDst ? 1 : OC / blockC;
     blockOCB = min(OCB, ispc::CPUConvKernel_getMaxBlockOCB());
-    while (OCB % blockOCB != 0)
+    while (blockOCB > 1 && (OCB % blockOCB != 0 || blockOCB * weightBlockByteSize > cacheSizes.L1))
       blockOCB--;
 
     OCBB = OCB / blockOCB;
-    blockOW = ispc::CPUConvKernel_getBlockOW(blockOCB);
+    blockOW = ispc::CPUConvKernel_getBlockOW(blockOCB, 1);
 
-    // Split the output width into tiles to fit into the L2 cache
-    const size_t cacheSize = 512 * 1024; // FIXME: query actual size but this also works well
+    // Compute two output rows at once, reusing the loaded source rows, if there are only a few output
+    // channel blocks, in which case the kernel is limited by the source loads (e.g. first encoder and
+    // last decoder convs). The output width must be split at multiples of both width blocks because
+    // rows with vertical padding are computed separately
+    const int blockOW2D = ispc::CPUConvKernel_getBlockOW(blockOCB, 2);
+    blockOH = 1;
+    if (blockOW2D > 0 && blockOCB * 2 <= ispc::CPUConvKernel_getMaxBlockOCB() &&
+        OH / batchSize >= 4 && engine->isConv2DBlockingEnabled())
+    {
+      blockOH = 2;
+      blockOW = lcm(blockOW, blockOW2D);
+    }
+
+    // With pooling, each task computes two output rows and pools them, which requires the output
+    // width to be split at even columns
+    const int taskOH = (postOp == PostOp::Pool) ? 2 : blockOH; // number of output rows per task
+    if (postOp == PostOp::Pool)
+      blockOW = lcm(blockOW, 2);
 
+    // Accumulate multiple blocks of input channels in registers, as many as the weights and the
+    // source rows of a width block fit into the L1 cache. Layers with many input channels (e.g.
+    // decoder convs with concatenated sources) are processed in multiple passes, accumulating the
+    // partial sums in the destination
+    const int ICB = IC / blockC;
+    const int kernelBlockOW = ispc::CPUConvKernel_getBlockOW(blockOCB, blockOH);
+    const size_t icBlockByteSize = blockOCB * weightBlockByteSize +
+      size_t(weightDesc.getH() + blockOH - 1) * (kernelBlockOW + weightDesc.getW() - 1) * blockC * srcElemByteSize;
+    blockICB = clamp(int(cacheSizes.L1 / icBlockByteSize), 1, ICB);
+
+    // Split the output width into tiles to fit into the L2 cache
+    const size_t weightAndBiasByteSize = weightDesc.getByteSize() + biasDesc.getByteSize();
+    const size_t tileByteSize = cacheSizes.L2 > weightAndBiasByteSize ? cacheSizes.L2 - weightAndBiasByteSize : 0;
     const int tileOW = max(
-      static_cast<int>((cacheSize - weightDesc.getByteSize() - biasDesc.getByteSize()) /
-                       (IC * getDataTypeSize(srcDesc.dataType)  * weightDesc.getH() +
-                        OC * getDataTypeSize(dstDesc.dataType)) - weightDesc.getW() + 1),
+      static_cast<int>(tileByteSize / (IC * srcElemByteSize * weightDesc.getH() + OC * dstElemByteSize)) -
+        weightDesc.getW() + 1,
       1);
 
     const int maxOWT = max(OW / (2*blockOW), 1); // max number of OW tiles
@@ -53,7 +97,7 @@ OIDN_NAMESPACE_BEGIN
     double bestThreadEff = 0;
     for (int curOWT = OWT; curOWT < maxOWT; ++curOWT)
     {
-      const size_t N = size_t(OCBB) * OH * curOWT; // work amount
+      const size_t N = size_t(OCBB) * ceil_div(OH, taskOH) * curOWT; // work amount
       const double threadEff = 1. - double(N % numThreads) / N;
       if (threadEff > bestThreadEff)
       {
@@ -63,41 +107,198 @@ OIDN_NAMESPACE_BEGIN
           break;
       }
     }
+
+    if (engine->getDevice()->isVerbose(3))
+    {
+      std::cout << "Conv blocking: " << IC << "x" << OC << "x" << OW
+                << " -> blockOCB=" << blockOCB << " blockICB=" << blockICB
+                << " blockOH=" << blockOH << " blockOW=" << blockOW << " OWT=" << OWT << std::endl;
+    }
+
+    // With pooling or destination processing, the output rows computed by a task are stored in a
+    // scratch before pooling or processing them. With upsampling, the source rows required by a
+    // task are upsampled into a scratch first
+    if (postOp == PostOp::Pool || processDst || upsampleSrc)
+    {
+      int maxTileOW = 0;
+      for (int owt = 0; owt < OWT; ++owt)
+      {
+        int owBegin, owEnd;
+        getTileOW(owt, owBegin, owEnd);
+        maxTileOW = max(maxTileOW, owEnd - owBegin);
+      }
+
+      if (postOp == PostOp::Pool || processDst)
+      {
+        threadScratchByteSize = round_up(
+          ispc::CPUConvKernel_getDstScratchByteSize(blockOCB, maxTileOW, toISPC(dstDesc.dataType)),
+          memoryAlignment);
+      }
+
+      if (upsampleSrc)
+      {
+        srcScratchOffset = threadScratchByteSize;
+        threadScratchByteSize += round_up(
+          ispc::CPUConvKernel_getUpsampleScratchByteSize(blockICB, blockOH, maxTileOW,
+                                                         toISPC(srcDesc.dataType)),
+          memoryAlignment);
+      }
+    }
+  }
+
+  void CPUConv::getTileOW(int owt, int& owBegin, int& owEnd) const
+  {
+    // Split the width at multiples of the width block, offset by the left padding so the blocks
+    // are aligned to the padding-free columns. With pooling, the split columns must be even instead
+    constexpr int PW = 1; // KW = 3
+    const int OW = srcDesc.getW();
+    const int offset = (postOp == PostOp::Pool) ? 0 : PW;
+    const int owr = OWT * (blockOW - offset - 1);
+    owBegin = owt   > 0   ? (owt     * OW + owr) / (OWT*blockOW) * blockOW + offset : 0;
+    owEnd   = owt+1 < OWT ? ((owt+1) * OW + owr) / (OWT*blockOW) * blockOW + offset : OW;
+  }
+
+  size_t CPUConv::getScratchByteSize()
+  {
+    return threadScratchByteSize * engine->getNumThreads();
+  }
+
+  void CPUConv::setScratch(const Ref<Buffer>& scratch)
+  {
+    if (scratch->getByteSize() < getScratchByteSize())
+      throw std::invalid_argument("convolution scratch buffer is too small");
+    this->scratch = scratch;
   }
 
   void CPUConv::submitKernels(const Ref<CancellationToken>& ct)
   {
-    if (!src || !dst)
+    auto func = getBandFunc();
+    const int OH = dstDesc.getH();
+
+    engine->submitFunc([=] { func(0, OH); }, ct);
+  }
+
+  std::function<void(int hBegin, int hEnd)> CPUConv::getBandFunc()
+  {
+    if (!src || (!dst && !dstProcess))
       throw std::logic_error("conving source/destination not set");
+    if (threadScratchByteSize > 0 && !scratch)
+      throw std::logic_error("convolution scratch not set");
 
     ispc::CPUConvKernel kernel;
     kernel.src    = *src;
+    kernel.src2   = {}; // no channels
+    if (src2)
+      kernel.src2 = *src2;
     kernel.weight = *weight;
     kernel.bias   = *bias;
-    kernel.dst    = *dst;
+    if (dstProcess)
+    {
+      // The destination is not stored in memory, only its shape is needed
+      kernel.dst   = {};
+      kernel.dst.C = dstDesc.getPaddedC();
+      kernel.dst.H = dstDesc.getH();
+      kernel.dst.W = dstDesc.getW();
+      auto outputProcess = dynamicRefCast<CPUOutputProcess>(dstProcess);
+      if (!outputProcess)
+        throw std::logic_error("unsupported convolution destination output processing");
+      kernel.outputProcess = outputProcess->getKernel();
+    }
+    else
+      kernel.dst  = *dst;
+    kernel.dataType = toISPC(srcDesc.dataType);
+    kernel.W      = srcDesc.getW(); // the source width after upsampling
+    kernel.batchH = srcDesc.getH() / batchSize; // the output height before pooling
     kernel.relu   = activation == Activation::ReLU;
+    kernel.srcUpsample = upsampleSrc;
+    kernel.dstProcess  = processDst;
+
+    uint8_t* scratchPtr = scratch ? static_cast<uint8_t*>(scratch->getPtr()) : nullptr;
+    const size_t threadScratchByteSize = this->threadScratchByteSize;
+    const size_t srcScratchOffset = this->srcScratchOffset;
+
+    if (postOp == PostOp::Pool)
+    {
+
+      // The rows are output rows after pooling, each computed from two rows before pooling
+      return [=](int ohBegin, int ohEnd)
+      {
+        const size_t N = size_t(OCBB) * (ohEnd - ohBegin) * OWT;
 
-    engine->submitFunc([=]
+        parallel_for(N, [&](size_t i)
+        {
+          const size_t j = i / OCBB;
+          const int ocbb = int(i % OCBB);
+          const int oh   = ohBegin + int(j % (ohEnd - ohBegin));
+          const int owt  = int(j / (ohEnd - ohBegin));
+
+          int owBegin, owEnd;
+          getTileOW(owt, owBegin, owEnd);
+
+          const int threadIndex = tbb::this_task_arena::current_thread_index();
+          uint8_t* threadScratchPtr = scratchPtr + size_t(threadIndex) * threadScratchByteSize;
+
+          ispc::CPUConvKernel_runPool(&kernel, blockOCB, blockICB, blockOH,
+                                      ocbb * blockOCB, oh * 2, owBegin, owEnd,
+                                      threadScratchPtr, threadScratchPtr + srcScratchOffset);
+        });
+      };
+    }
+
+    if (processDst)
+    {
+      // Only the first output channel block is computed and passed to the output processing
+      return [=](int ohBegin, int ohEnd)
+      {
+        const int OHB = ceil_div(ohEnd - ohBegin, blockOH); // number of output row blocks
+        const size_t N = size_t(OHB) * OWT;
+
+        parallel_for(N, [&](size_t i)
+        {
+          const int oh  = ohBegin + int(i % OHB) * blockOH;
+          const int owt = int(i / OHB);
+
+          int owBegin, owEnd;
+          getTileOW(owt, owBegin, owEnd);
+
+          const int threadIndex = tbb::this_task_arena::current_thread_index();
+          uint8_t* threadScratchPtr = scratchPtr + size_t(threadIndex) * threadScratchByteSize;
+
+          ispc::CPUConvKernel_runProcess(&kernel, blockICB, min(blockOH, ohEnd - oh),
+                                         oh, owBegin, owEnd,
+                                         threadScratchPtr, threadScratchPtr + srcScratchOffset);
+        });
+      };
+    }
+
+    return [=](int ohBegin, int ohEnd)
     {
-      const int OH = kernel.dst.H;
-      const int OW = kernel.dst.W;
-      const size_t N = size_t(OCBB) * OH * OWT;
+      const int OH = ohEnd - ohBegin;
+      const int OHB = ceil_div(OH, blockOH); // number of output row blocks
+      const size_t N = size_t(OCBB) * OHB * OWT;
 
       parallel_for(N, [&](size_t i)
       {
         const size_t j = i / OCBB;
         const int ocbb = int(i % OCBB);
-        const int oh   = int(j % OH);
-        const int owt  = int(j / OH);
+        const int oh   = ohBegin + int(j % OHB) * blockOH;
+        const int owt  = int(j / OHB);
+
+        int owBegin, owEnd;
+        getTileOW(owt, owBegin, owEnd);
 
-        constexpr int PW = 1; // KW = 3
-        const int owr = OWT * (blockOW - PW - 1);
-        const int owBegin = owt   > 0   ? (owt     * OW + owr) / (OWT*blockOW) * blockOW + PW : 0;
-        const int owEnd   = owt+1 < OWT ? ((owt+1) * OW + owr) / (OWT*blockOW) * blockOW + PW : OW;
+        // The scratch is needed only for upsampling the source
+        uint8_t* srcScratchPtr = nullptr;
+        if (kernel.srcUpsample)
+        {
+          const int threadIndex = tbb::this_task_arena::current_thread_index();
+          srcScratchPtr = scratchPtr + size_t(threadIndex) * threadScratchByteSize + srcScratchOffset;
+        }
 
-        ispc::CPUConvKernel_run(&kernel, blockOCB, ocbb * blockOCB, oh, owBegin, owEnd);
+        ispc::CPUConvKernel_run(&kernel, blockOCB, blockICB, min(blockOH, ohEnd - oh),
+                                ocbb * blockOCB, oh, owBegin, owEnd, srcScratchPtr);
       });
-    }, ct);
+    };
   }
 
 OIDN_NAMESPACE_END
\ No newline at end of file
@@ -5,23 +5,57 @@
 
 #include "core/conv.h"
 #include "cpu_engine.h"
+#include "cpu_band_op.h"
 
 OIDN_NAMESPACE_BEGIN
 
-  class CPUConv final : public Conv
+  class CPUConv final : public Conv, public CPUBandOp
   {
   public:
     CPUConv(CPUEngine* engine, const ConvDesc& desc);
 
     Engine* getEngine() const override { return engine; }
+    bool isSrc2Supported() const override { return engine->isConcatFusionEnabled(); }
+
+    size_t getScratchByteSize() override;
+    void setScratch(const Ref<Buffer>& scratch) override;
+
+    bool getAccesses(std::vector<MemoryAccess>& accesses) const override
+    {
+      // Only the op scratch at the beginning of the scratch buffer is used (the graph may store
+      // tensors after it)
+      if (scratch)
+      {
+        const size_t opScratchByteSize = threadScratchByteSize * engine->getNumThreads();
+        addAccess(accesses, scratch->getPtr(), opScratchByteSize, true);
+      }
+      return Conv::getAccesses(accesses);
+    }
+
     void submitKernels(const Ref<CancellationToken>& ct) override;
 
+    TensorDesc getBandDstDesc() const override { return dstDesc; }
+    int getBandSrcH(int H) const override // KH = 3
+    {
+      const int srcH = (postOp == PostOp::Pool) ? H * 2 + 1 : H + 1;
+      return upsampleSrc ? ceil_div(srcH, 2) : srcH;
+    }
+    std::function<void(int hBegin, int hEnd)> getBandFunc() override;
+
   private:
+    // Returns the range of output columns of a width tile
+    void getTileOW(int owt, int& owBegin, int& owEnd) const;
+
     CPUEngine* engine;
     int blockOCB; // block of output channel blocks
-    int blockOW;  // block of output width
+    int blockICB; // block of input channel blocks accumulated in registers
+    int blockOH;  // block of output rows (1 or 2)
+    int blockOW;  // block of output width (multiple of the width blocks of the kernel)
     int OCBB;     // number of output channel block blocks
     int OWT;      // number of output width tiles
+    size_t threadScratchByteSize = 0; // scratch size per thread (only for pooling, upsampling and processing)
+    size_t srcScratchOffset = 0;      // offset of the upsampled source rows in the thread scratch
+    Ref<Buffer> scratch;
   };
 
 OIDN_NAMESPACE_END
\ No newline at end of file
@@ -20,6 +20,13 @@
   #endif
 #endif
 
+#if defined(OIDN_AMX) && defined(__linux__)
+  #include <unistd.h>
+  #include <sys/syscall.h>
+  #define OIDN_ARCH_REQ_XCOMP_PERM   0x1023
+  #define OIDN_XFEATURE_XTILEDATA    18
+#endif
+
 OIDN_NAMESPACE_BEGIN
 
 #if defined(OIDN_ARCH_X64) && !defined(__APPLE__)
@@ -31,6 +38,58 @@ OIDN_NAMESPACE_BEGIN
     __cpuid(functionID, cpuInfo[0], cpuInfo[1], cpuInfo[2], cpuInfo[3]);
   #endif
   }
+
+  oidn_inline void cpuid(int cpuInfo[4], int functionID, int subfunctionID)
+  {
+  #if defined(_WIN32)
+    __cpuidex(cpuInfo, functionID, subfunctionID);
+  #else
+    __cpuid_count(functionID, subfunctionID, cpuInfo[0], cpuInfo[1], cpuInfo[2], cpuInfo[3]);
+  #endif
+  }
+#endif
+
+#if defined(OIDN_AMX)
+  // Returns the state components enabled by the OS (XCR0)
+  oidn_inline uint64_t xgetbv()
+  {
+  #if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+  #else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (uint64_t(edx) << 32) | eax;
+  #endif
+  }
+
+  // Checks whether AMX tiles with BF16 support are available and enabled by the OS. On Linux,
+  // the process must also request permission to use the tile data state
+  static bool detectAMX()
+  {
+    int regs[4];
+    cpuid(regs, 7, 0);
+    const bool amxBF16 = regs[3] & (1 << 22);
+    const bool amxTile = regs[3] & (1 << 24);
+    if (!amxBF16 || !amxTile)
+      return false;
+
+    const uint64_t tileStateMask = (1 << 17) | (1 << 18); // XTILECFG, XTILEDATA
+    if ((xgetbv() & tileStateMask) != tileStateMask)
+      return false;
+
+  #if defined(__linux__)
+    if (syscall(SYS_arch_prctl, OIDN_ARCH_REQ_XCOMP_PERM, OIDN_XFEATURE_XTILEDATA) != 0)
+      return false;
+  #endif
+
+    return true;
+  }
+
+  static bool isAMXSupported()
+  {
+    static const bool supported = detectAMX();
+    return supported;
+  }
 #endif
 
   CPUPhysicalDevice::CPUPhysicalDevice(int score)
@@ -82,7 +141,11 @@ OIDN_NAMESPACE_BEGIN
     {
     case ispc::CPUArch_SSE4:   return CPUArch::SSE41;
     case ispc::CPUArch_AVX2:   return CPUArch::AVX2;
+  #if defined(OIDN_AMX)
+    case ispc::CPUArch_AVX512: return isAMXSupported() ? CPUArch::AVX512_AMX : CPUArch::AVX512;
+  #else
     case ispc::CPUArch_AVX512: return CPUArch::AVX512;
+  #endif
     case ispc::CPUArch_NEON:   return CPUArch::NEON;
     default:                   return CPUArch::Unknown;
     }
@@ -96,16 +159,33 @@ OIDN_NAMESPACE_BEGIN
     // Get default values from environment variables
     getEnvVar("OIDN_NUM_THREADS", numThreads);
     getEnvVar("OIDN_SET_AFFINITY", setAffinity);
+    getEnvVar("OIDN_NUMA_SUBDEVICES", numaSubdevices);
+    getEnvVar("OIDN_NUM_STREAMS", numStreamsParam);
   }
 
   void CPUDevice::init()
   {
     arch = getArch();
 
+    // Query the cache sizes for blocking the kernels, falling back to conservative defaults
+    // The sizes can be overridden with hidden parameters for testing
+    cacheSizes = getCPUCacheSizes();
+    if (l1CacheSizeParam > 0)
+      cacheSizes.L1 = l1CacheSizeParam;
+    if (l2CacheSizeParam > 0)
+      cacheSizes.L2 = l2CacheSizeParam;
+    if (cacheSizes.L1 == 0)
+      cacheSizes.L1 = 32 * 1024;
+    if (cacheSizes.L2 == 0)
+      cacheSizes.L2 = 512 * 1024;
+
+    if (numStreamsParam < 1)
+      throw Exception(Error::InvalidArgument, "invalid number of streams");
+
     tensorDataType = DataType::Float32;
     weightDataType = DataType::Float32;
 
-    std::unique_ptr<CPUEngine> engine;
+    std::vector<std::unique_ptr<CPUEngine>> engines;
 
   #if defined(OIDN_DNNL)
     if (arch == CPUArch::AVX512)
@@ -121,15 +201,17 @@ OIDN_NAMESPACE_BEGIN
       tensorBlockC = 8;
     }
 
-    engine.reset(new DNNLEngine(this, numThreads));
+    for (int stream = 0; stream < numStreamsParam; ++stream)
+      engines.emplace_back(new DNNLEngine(this, numThreads, stream, numStreamsParam));
   #elif defined(OIDN_BNNS)
     tensorLayout = TensorLayout::chw;
     weightLayout = TensorLayout::oihw;
     tensorBlockC = 1;
 
-    engine.reset(new BNNSEngine(this, numThreads));
+    for (int stream = 0; stream < numStreamsParam; ++stream)
+      engines.emplace_back(new BNNSEngine(this, numThreads, stream, numStreamsParam));
   #else
-    if (arch == CPUArch::AVX512)
+    if (arch == CPUArch::AVX512 || arch == CPUArch::AVX512_AMX)
     {
       tensorLayout = TensorLayout::Chw16c;
       weightLayout = TensorLayout::IOhw16i16o;
@@ -142,13 +224,31 @@ OIDN_NAMESPACE_BEGIN
       tensorBlockC = 8;
     }
 
-    engine.reset(new CPUEngine(this, numThreads));
+    // Create a subdevice for each NUMA node if requested, dividing the threads evenly
+    // Each stream has its own subdevices, which divide the threads of the NUMA nodes further
+    const std::vector<int> numaNodes = numaSubdevices ? getNUMANodes() : std::vector<int>();
+    for (int stream = 0; stream < numStreamsParam; ++stream)
+    {
+      if (numaNodes.size() > 1)
+      {
+        const int numNodeThreads = (numThreads > 0) ? max(numThreads / int(numaNodes.size()), 1) : 0;
+        for (int numaNode : numaNodes)
+          engines.emplace_back(new CPUEngine(this, numNodeThreads, numaNode, stream, numStreamsParam));
+      }
+      else
+        engines.emplace_back(new CPUEngine(this, numThreads, -1, stream, numStreamsParam));
+    }
   #endif
 
-    numThreads = engine->arena->max_concurrency();
-    setAffinity = bool(engine->affinity);
+    numThreads = 0;
+    for (const auto& engine : engines)
+      numThreads += engine->arena->max_concurrency();
+    setAffinity = bool(engines[0]->affinity);
+    numStreams = numStreamsParam;
+    numaSubdevices = int(engines.size()) > numStreams;
 
-    subdevices.emplace_back(new Subdevice(std::move(engine)));
+    for (auto& engine : engines)
+      subdevices.emplace_back(new Subdevice(std::move(engine)));
 
     if (isVerbose())
     {
@@ -157,14 +257,19 @@ OIDN_NAMESPACE_BEGIN
       std::cout << "    ISA     : ";
       switch (arch)
       {
-      case CPUArch::SSE2:   std::cout << "SSE2";    break;
-      case CPUArch::SSE41:  std::cout << "SSE4.1";  break;
-      case CPUArch::AVX2:   std::cout << "AVX2";    break;
-      case CPUArch::AVX512: std::cout << "AVX-512"; break;
-      case CPUArch::NEON:   std::cout << "NEON";    break;
-      default:              std::cout << "Unknown"; break;
+      case CPUArch::SSE2:       std::cout << "SSE2";         break;
+      case CPUArch::SSE41:      std::cout << "SSE4.1";       break;
+      case CPUArch::AVX2:       std::cout << "AVX2";         break;
+      case CPUArch::AVX512:     std::cout << "AVX-512";      break;
+      case CPUArch::AVX512_AMX: std::cout << "AVX-512, AMX"; break;
+      case CPUArch::NEON:       std::cout << "NEON";         break;
+      default:                  std::cout << "Unknown";      break;
       }
       std::cout << std::endl;
+      std::cout << "    Caches  : L1 " << (cacheSizes.L1 >> 10) << " KB, L2 " << (cacheSizes.L2 >> 10) << " KB";
+      if (cacheSizes.L3 > 0)
+        std::cout << ", L3 " << (cacheSizes.L3 >> 10) << " KB";
+      std::cout << std::endl;
 
       std::cout << "  Tasking   :";
       std::cout << " TBB" << TBB_VERSION_MAJOR << "." << TBB_VERSION_MINOR;
@@ -175,6 +280,10 @@ OIDN_NAMESPACE_BEGIN
     #endif
       std::cout << std::endl;
       std::cout << "    Threads : " << numThreads << " (" << (setAffinity ? "affinitized" : "non-affinitized") << ")" << std::endl;
+      if (numaSubdevices)
+        std::cout << "    NUMA    : " << getNumStreamSubdevices() << " subdevices" << std::endl;
+      if (numStreams > 1)
+        std::cout << "    Streams : " << numStreams << std::endl;
     }
   }
 
@@ -189,6 +298,34 @@ OIDN_NAMESPACE_BEGIN
       return numThreads;
     else if (name == "setAffinity")
       return setAffinity;
+    else if (name == "numaSubdevices")
+      return numaSubdevices;
+    else if (name == "numStreams")
+      return numStreamsParam;
+    else if (name == "depthFirst")
+      return depthFirst;
+    else if (name == "concurrency")
+      return concurrency;
+    else if (name == "dependencyTracking")
+      return dependencyTracking;
+    else if (name == "conv2DBlocking")
+      return conv2DBlocking;
+    else if (name == "winograd")
+      return winograd;
+    else if (name == "amx")
+      return amx;
+    else if (name == "concatFusion")
+      return concatFusion;
+    else if (name == "poolFusion")
+      return poolFusion;
+    else if (name == "upsampleFusion")
+      return upsampleFusion;
+    else if (name == "outputFusion")
+      return outputFusion;
+    else if (name == "l1CacheSize")
+      return int(cacheSizes.L1);
+    else if (name == "l2CacheSize")
+      return int(cacheSizes.L2);
     else
       return Device::getInt(name);
   }
@@ -209,12 +346,61 @@ OIDN_NAMESPACE_BEGIN
       else if (setAffinity != bool(value))
         printWarning("OIDN_SET_AFFINITY environment variable overrides device parameter");
     }
+    else if (name == "numaSubdevices")
+    {
+      if (!isEnvVar("OIDN_NUMA_SUBDEVICES"))
+        numaSubdevices = value;
+      else if (numaSubdevices != bool(value))
+        printWarning("OIDN_NUMA_SUBDEVICES environment variable overrides device parameter");
+    }
+    else if (name == "numStreams")
+    {
+      if (!isEnvVar("OIDN_NUM_STREAMS"))
+        numStreamsParam = value;
+      else if (numStreamsParam != value)
+        printWarning("OIDN_NUM_STREAMS environment variable overrides device parameter");
+    }
+    else if (name == "depthFirst")
+      depthFirst = value;
+    else if (name == "concurrency")
+      concurrency = value;
+    else if (name == "dependencyTracking")
+      dependencyTracking = value;
+    else if (name == "conv2DBlocking")
+      conv2DBlocking = value;
+    else if (name == "winograd")
+      winograd = value;
+    else if (name == "amx")
+      amx = value;
+    else if (name == "concatFusion")
+      concatFusion = value;
+    else if (name == "poolFusion")
+      poolFusion = value;
+    else if (name == "upsampleFusion")
+      upsampleFusion = value;
+    else if (name == "outputFusion")
+      outputFusion = value;
+    else if (name == "l1CacheSize")
+      l1CacheSizeParam = value;
+    else if (name == "l2CacheSize")
+      l2CacheSizeParam = value;
     else
       Device::setInt(name, value);
 
     dirty = true;
   }
 
+  void CPUDevice::submitBarrier(int stream)
+  {
+    // The engines of NUMA subdevices have separate queues, which can be synchronized only by
+    // waiting for all of them
+    if (getNumStreamSubdevices() > 1)
+    {
+      for (int i = 0; i < getNumStreamSubdevices(); ++i)
+        getStreamEngine(stream, i)->wait();
+    }
+  }
+
   void CPUDevice::wait()
   {
     for (auto& subdevice : subdevices)
@@ -18,6 +18,7 @@ OIDN_NAMESPACE_BEGIN
     SSE41,
     AVX2,
     AVX512,
+    AVX512_AMX, // AVX-512 with AMX tiles (BF16)
     NEON
   };
 
@@ -41,14 +42,31 @@ OIDN_NAMESPACE_BEGIN
 
     DeviceType getType() const override { return DeviceType::CPU; }
 
+    // Cache sizes of the CPU cores, with default values for the unknown sizes
+    const CPUCacheSizes& getCacheSizes() const { return cacheSizes; }
+
+    // Optional execution paths, which can be disabled with hidden parameters for testing
+    bool isDepthFirstEnabled()         const { return depthFirst; }
+    bool isConcurrencyEnabled()        const { return concurrency; }
+    bool isDependencyTrackingEnabled() const { return dependencyTracking; }
+    bool isConv2DBlockingEnabled()     const { return conv2DBlocking; }
+    bool isWinogradEnabled()           const { return winograd; }
+    bool isAMXEnabled()                const { return amx; }
+    bool isConcatFusionEnabled()       const { return concatFusion; }
+    bool isPoolFusionEnabled()         const { return poolFusion; }
+    bool isUpsampleFusionEnabled()     const { return upsampleFusion; }
+    bool isOutputFusionEnabled()       const { return outputFusion; }
+
   #if !defined(OIDN_DNNL)
-    bool needWeightAndBiasOnDevice() const override { return false; } // no need to copy
+    // No need to copy, except for NUMA subdevices, which should have their own copies
+    bool needWeightAndBiasOnDevice() const override { return numaSubdevices; }
   #endif
     Storage getPtrStorage(const void* ptr) override;
 
     int getInt(const std::string& name) override;
     void setInt(const std::string& name, int value) override;
 
+    void submitBarrier(int stream) override;
     void wait() override;
 
   protected:
@@ -56,9 +74,26 @@ OIDN_NAMESPACE_BEGIN
 
   private:
     CPUArch arch = CPUArch::Unknown;
+    CPUCacheSizes cacheSizes;
 
     int numThreads = 0; // autodetect by default
     bool setAffinity = true;
+    bool numaSubdevices = false; // create a subdevice for each NUMA node
+    int numStreamsParam = 1;     // number of streams to create, dividing the threads evenly
+
+    // Optional execution paths (hidden parameters, for testing)
+    bool depthFirst         = true; // execute op chains depth-first in bands of rows
+    bool concurrency        = true; // execute functions concurrently (e.g. pipelined tiles)
+    bool dependencyTracking = true; // execute independent tasks concurrently in a task graph
+    bool conv2DBlocking     = true; // compute two output rows at once in the convolutions
+    bool winograd           = true; // use the Winograd convolution with fast math
+    bool amx                = true; // use the AMX convolution if supported
+    bool concatFusion       = true; // read the concat+conv sources from separate tensors
+    bool poolFusion         = true; // fuse the pooling into the preceding convolution
+    bool upsampleFusion     = true; // fuse the upsampling into the following concat+conv
+    bool outputFusion       = true; // fuse the output processing into the last convolution
+    int l1CacheSizeParam = 0;       // override the detected L1 cache size if > 0
+    int l2CacheSizeParam = 0;       // override the detected L2 cache size if > 0
   };
 
 OIDN_NAMESPACE_END
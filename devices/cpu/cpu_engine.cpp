@@ -4,6 +4,11 @@
 #include "cpu_engine.h"
 #if !defined(OIDN_DNNL) && !defined(OIDN_BNNS)
   #include "cpu_conv.h"
+  #include "cpu_winograd_conv.h"
+  #include "cpu_int8_conv.h"
+  #if defined(OIDN_AMX)
+    #include "cpu_amx_conv.h"
+  #endif
 #endif
 #include "cpu_pool.h"
 #include "cpu_upsample.h"
@@ -11,15 +16,28 @@
 #include "cpu_input_process.h"
 #include "cpu_output_process.h"
 #include "cpu_image_copy.h"
+#include "cpu_tile_variance.h"
+#include "cpu_tile_pass_through.h"
+#include "cpu_band_op.h"
 
 OIDN_NAMESPACE_BEGIN
 
-  CPUEngine::CPUEngine(CPUDevice* device, int numThreads)
-    : device(device)
+  CPUEngine::CPUEngine(CPUDevice* device, int numThreads, int numaNode,
+                       int stream, int numStreams)
+    : device(device),
+      numaNode(numaNode)
   {
+    if (numaNode >= 0)
+    {
+      // Pin the threads to the CPUs of the NUMA node (one thread per core if affinitization is
+      // enabled), so the memory they first-touch is also allocated on the node
+      affinity = std::make_shared<ThreadAffinity>(device->setAffinity ? 1 : INT_MAX, device->verbose, numaNode);
+      if (affinity->getNumThreads() == 0)
+        affinity.reset(); // detection failed
+    }
     // Get the thread affinities for one thread per core on non-hybrid CPUs with SMT
   #if !(defined(__APPLE__) && defined(OIDN_ARCH_ARM64))
-    if (device->setAffinity
+    else if (device->setAffinity
       #if TBB_INTERFACE_VERSION >= 12020 // oneTBB 2021.2 or later
         && tbb::info::core_types().size() <= 1 // non-hybrid cores
       #endif
@@ -36,11 +54,23 @@ OIDN_NAMESPACE_BEGIN
     // Create the task arena
     const int maxNumThreads = affinity ? affinity->getNumThreads() : tbb::this_task_arena::max_concurrency();
     numThreads = (numThreads > 0) ? min(numThreads, maxNumThreads) : maxNumThreads;
-    arena = std::make_shared<tbb::task_arena>(numThreads);
+
+    // Use only the share of the threads of the stream, pinned to a separate range of cores
+    numThreads = max(numThreads / numStreams, 1);
+    const int threadOffset = (stream * numThreads) % maxNumThreads;
+  #if TBB_INTERFACE_VERSION >= 12020 // oneTBB 2021.2 or later
+    // Constrain the arena to the NUMA node too if TBB can detect it (requires TBBBind)
+    const std::vector<tbb::numa_node_id> tbbNUMANodes = tbb::info::numa_nodes();
+    if (numaNode >= 0 &&
+        std::find(tbbNUMANodes.begin(), tbbNUMANodes.end(), numaNode) != tbbNUMANodes.end())
+      arena = std::make_shared<tbb::task_arena>(tbb::task_arena::constraints(numaNode, numThreads));
+    else
+  #endif
+      arena = std::make_shared<tbb::task_arena>(numThreads);
 
     // Automatically set the thread affinities
     if (affinity)
-      observer = std::make_shared<PinningObserver>(affinity, *arena);
+      observer = std::make_shared<PinningObserver>(affinity, *arena, threadOffset);
 
     // Start the queue processing thread
     queueThread = std::thread([&]() { processQueue(); });
@@ -48,20 +78,69 @@ OIDN_NAMESPACE_BEGIN
 
   CPUEngine::~CPUEngine()
   {
-    {
-      std::lock_guard<std::mutex> lock(queueMutex);
-      queueShutdown = true;
-    }
-    queueCond.notify_all();
+    queueShutdown = true;
+    numPushed.add(); // wake up the queue thread
     queueThread.join();
 
+    // Wait for the task runners to exit, which may still be running after completing their tasks
+    while (numRunners > 0)
+      std::this_thread::yield();
+
     if (observer)
       observer.reset();
   }
 
 #if !defined(OIDN_DNNL) && !defined(OIDN_BNNS)
+  bool CPUEngine::isConvSupported(const ConvDesc& desc)
+  {
+    // Must match the implementation selected by newConv. Only the direct floating-point
+    // convolution supports fused pooling and output processing, and the int8 and Winograd
+    // convolutions do not support upsampling the source
+    if (desc.srcDesc.dataType == DataType::UInt8)
+      return desc.postOp == PostOp::None && !desc.upsampleSrc && !desc.processDst;
+
+    // Upsampling the first concat source requires reading the sources from separate tensors
+    if (desc.upsampleSrc && !(device->isUpsampleFusionEnabled() && device->isConcatFusionEnabled()))
+      return false;
+
+    // With output processing, all output channels must be in a single channel block. It is not
+    // supported with fast math, which would replace the faster AMX or Winograd convolution
+    const bool is3x3 = desc.weightDesc.getH() == 3 && desc.weightDesc.getW() == 3;
+    if (desc.processDst)
+      return device->isOutputFusionEnabled() && desc.postOp == PostOp::None &&
+             desc.weightDesc.getO() <= device->getTensorBlockC() && !(desc.fastMath && is3x3);
+
+  #if defined(OIDN_AMX)
+    if (device->arch == CPUArch::AVX512_AMX && device->isAMXEnabled() && desc.fastMath && is3x3)
+      return desc.postOp == PostOp::None;
+  #endif
+    if (desc.fastMath && is3x3 && device->isWinogradEnabled())
+      return desc.postOp == PostOp::None && !desc.upsampleSrc;
+
+    return desc.postOp == PostOp::None ||
+           (desc.postOp == PostOp::Pool && device->isPoolFusionEnabled());
+  }
+
   Ref<Conv> CPUEngine::newConv(const ConvDesc& desc)
   {
+    // Quantized sources require the int8 convolution
+    if (desc.srcDesc.dataType == DataType::UInt8)
+      return makeRef<CPUInt8Conv>(this, desc);
+
+  #if defined(OIDN_AMX)
+    // Use the much faster AMX convolution if fast math is enabled, as it computes in BF16
+    if (device->arch == CPUArch::AVX512_AMX && device->isAMXEnabled() && desc.fastMath &&
+        desc.postOp == PostOp::None && !desc.processDst &&
+        desc.weightDesc.getH() == 3 && desc.weightDesc.getW() == 3)
+      return makeRef<CPUAMXConv>(this, desc);
+  #endif
+
+    // Use the faster but slightly less accurate Winograd convolution if fast math is enabled
+    if (device->isWinogradEnabled() && desc.fastMath && desc.postOp == PostOp::None &&
+        !desc.upsampleSrc && !desc.processDst &&
+        desc.weightDesc.getH() == 3 && desc.weightDesc.getW() == 3)
+      return makeRef<CPUWinogradConv>(this, desc);
+
     return makeRef<CPUConv>(this, desc);
   }
 #endif
@@ -96,13 +175,113 @@ OIDN_NAMESPACE_BEGIN
     return makeRef<CPUImageCopy>(this);
   }
 
-  void CPUEngine::submitFunc(std::function<void()>&& f, const Ref<CancellationToken>& ct)
+  Ref<TileVariance> CPUEngine::newTileVariance()
   {
+    return makeRef<CPUTileVariance>(this);
+  }
+
+  Ref<TilePassThrough> CPUEngine::newTilePassThrough(const TilePassThroughDesc& desc)
+  {
+    return makeRef<CPUTilePassThrough>(this, desc);
+  }
+
+  size_t CPUEngine::submitDepthFirst(const std::vector<Ref<Op>>& ops, size_t begin, size_t end,
+                                     const Ref<Progress>& progress)
+  {
+    if (!device->isDepthFirstEnabled())
+      return 0;
+
+    // Get the ops at the beginning of the chain which can be computed in bands
+    std::vector<CPUBandOp*> bandOps;
+    size_t workAmount = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+      CPUBandOp* bandOp = dynamic_cast<CPUBandOp*>(ops[i].get());
+      if (!bandOp)
+        break;
+      bandOps.push_back(bandOp);
+      workAmount += ops[i]->getWorkAmount();
+    }
+
+    const int numOps = int(bandOps.size());
+    if (numOps < 2)
+      return 0;
+
+    // Compute the band height of the last op such that the rows produced by all ops for a band
+    // fit into the caches of the threads (about half of the L2, leaving room for the weights)
+    const size_t cacheSize = getCacheSizes().L2 / 2;
+    const int lastH = bandOps.back()->getBandDstDesc().getH();
+    double rowByteSize = 0; // total amount of data produced per row of the last op
+    for (CPUBandOp* bandOp : bandOps)
     {
-      std::lock_guard<std::mutex> lock(queueMutex);
-      queue.push({std::move(f), ct});
+      const TensorDesc dstDesc = bandOp->getBandDstDesc();
+      rowByteSize += double(dstDesc.getByteSize()) / lastH;
     }
-    queueCond.notify_all();
+
+    const int minBandH = 2;
+    const int bandH = max(int(double(cacheSize) * getNumThreads() / rowByteSize), minBandH);
+    if (bandH >= lastH)
+      return 0; // a single band would not help
+
+    // Get the heights and the band functions of the ops
+    std::vector<int> H(numOps);
+    std::vector<std::function<void(int, int)>> funcs(numOps);
+    for (int k = 0; k < numOps; ++k)
+    {
+      H[k] = bandOps[k]->getBandDstDesc().getH();
+      funcs[k] = bandOps[k]->getBandFunc();
+    }
+
+    // The chain accesses the memory of all its ops
+    std::vector<MemoryAccess> chainAccesses;
+    bool trackAccesses = isDependencyTrackingSupported();
+    for (int k = 0; k < numOps && trackAccesses; ++k)
+      trackAccesses = ops[begin + k]->getAccesses(chainAccesses);
+    if (trackAccesses)
+      beginAccesses(chainAccesses);
+
+    if (progress)
+      Progress::submitUpdate(this, progress);
+
+    // Pull bands of rows through the chain: for each band of the last op, compute backwards the
+    // rows required from the previous ops, then compute the missing rows forwards
+    submitFunc([=]
+    {
+      std::vector<int> hDone(numOps, 0); // number of rows already computed for each op
+      std::vector<int> hEnd(numOps);     // number of rows to be computed for each op
+
+      while (hDone[numOps-1] < H[numOps-1])
+      {
+        if (progress && progress->isCancelled())
+          return;
+
+        hEnd[numOps-1] = min(hDone[numOps-1] + bandH, H[numOps-1]);
+        for (int k = numOps-1; k > 0; --k)
+          hEnd[k-1] = (hEnd[k] == H[k]) ? H[k-1] : min(bandOps[k]->getBandSrcH(hEnd[k]), H[k-1]);
+
+        for (int k = 0; k < numOps; ++k)
+        {
+          if (hEnd[k] > hDone[k])
+          {
+            funcs[k](hDone[k], hEnd[k]);
+            hDone[k] = hEnd[k];
+          }
+        }
+      }
+    }, progress);
+
+    if (progress)
+      Progress::submitUpdate(this, progress, workAmount);
+
+    if (trackAccesses)
+      endAccesses();
+
+    return size_t(numOps);
+  }
+
+  void CPUEngine::submitFunc(std::function<void()>&& f, const Ref<CancellationToken>& ct)
+  {
+    pushTask({std::move(f), ct, curAccesses.get(), concurrent, false});
   }
 
   void CPUEngine::submitHostFunc(std::function<void()>&& f, const Ref<CancellationToken>& ct)
@@ -110,11 +289,46 @@ OIDN_NAMESPACE_BEGIN
     submitFunc(std::move(f), ct);
   }
 
+  void CPUEngine::beginConcurrent()
+  {
+    if (concurrent)
+      throw std::logic_error("concurrent submission has already begun");
+    concurrent = true;
+  }
+
+  void CPUEngine::endConcurrent()
+  {
+    if (!concurrent)
+      throw std::logic_error("concurrent submission has not begun");
+    concurrent = false;
+  }
+
+  void CPUEngine::submitJoin()
+  {
+    // The join depends on all preceding tasks, so it does not have to do anything
+    pushTask({nullptr, nullptr, nullptr, false, true});
+  }
+
+  void CPUEngine::beginAccesses(const std::vector<MemoryAccess>& accesses)
+  {
+    curAccesses.get() = std::make_shared<const MemoryAccesses>(accesses);
+  }
+
+  void CPUEngine::endAccesses()
+  {
+    curAccesses.get().reset();
+  }
+
   void CPUEngine::wait()
   {
+    // Wait until all tasks pushed so far have been completed (the counters may wrap around)
+    const uint32_t target = uint32_t(queue.getPushCount());
+    for (; ;)
     {
-      std::unique_lock<std::mutex> lock(queueMutex);
-      queueCond.wait(lock, [&] { return queue.empty(); });
+      const uint32_t completed = numCompleted.load();
+      if (int32_t(completed - target) >= 0)
+        break;
+      numCompleted.wait(completed);
     }
   }
 
@@ -125,7 +339,24 @@ OIDN_NAMESPACE_BEGIN
 
     if (byteSize == 0)
       return nullptr;
-    return alignedMalloc(byteSize);
+    void* ptr = alignedMalloc(byteSize);
+
+    // First-touch the memory with the threads of the engine to allocate the pages on its NUMA node
+    if (numaNode >= 0)
+    {
+      const size_t pageSize = 4096;
+      const size_t numPages = ceil_div(byteSize, pageSize);
+      arena->execute([&]
+      {
+        parallel_for(numPages, [&](size_t i)
+        {
+          const size_t offset = i * pageSize;
+          std::memset(static_cast<char*>(ptr) + offset, 0, min(pageSize, byteSize - offset));
+        });
+      });
+    }
+
+    return ptr;
   }
 
   void CPUEngine::usmFree(void* ptr, Storage storage)
@@ -142,48 +373,248 @@ OIDN_NAMESPACE_BEGIN
 
   void CPUEngine::submitUSMCopy(void* dstPtr, const void* srcPtr, size_t byteSize)
   {
-    submitFunc([=] { std::memcpy(dstPtr, srcPtr, byteSize); });
+    auto copyAccesses = std::make_shared<MemoryAccesses>();
+    copyAccesses->push_back({srcPtr, static_cast<const char*>(srcPtr) + byteSize, false});
+    copyAccesses->push_back({dstPtr, static_cast<char*>(dstPtr) + byteSize, true});
+
+    pushTask({[=] { std::memcpy(dstPtr, srcPtr, byteSize); }, nullptr, copyAccesses, concurrent, false});
+  }
+
+  void CPUEngine::pushTask(Task&& task)
+  {
+    // If the queue is full, wait until the queue thread completes some tasks
+    for (; ;)
+    {
+      const uint32_t completed = numCompleted.load();
+      if (queue.tryPush(std::move(task)))
+        break;
+      numCompleted.wait(completed);
+    }
+
+    numPushed.add();
   }
 
   void CPUEngine::processQueue()
   {
+    std::vector<TaskNode*> readyNodes;
+
     for (; ;)
     {
       Task task;
 
-      // Wait until a task is available in the queue
+      // Add the queued tasks to the graph until the queue gets empty
+      const uint32_t pushed = numPushed.load();
+      while (queue.tryPop(task))
       {
-        std::unique_lock<std::mutex> lock(queueMutex);
-        queueCond.wait(lock, [&] { return !queue.empty() || queueShutdown; });
-        if (queue.empty() && queueShutdown)
-          return;
-        task = std::move(queue.front());
+        // If the graph is full, help executing the ready tasks or wait until some get retired
+        for (; ;)
+        {
+          const uint32_t completed = numCompleted.load();
+          {
+            std::lock_guard<std::mutex> lock(graphMutex);
+            if (taskNodes.size() < maxNumGraphTasks)
+            {
+              addTaskNode(std::move(task), readyNodes);
+              break;
+            }
+          }
+
+          scheduleTaskNodes(readyNodes);
+          if (!executeReadyTaskNode())
+            numCompleted.wait(completed);
+        }
+
+        task = {};
       }
 
-      // Execute queued tasks in the arena until the queue gets empty
-      arena->execute([&]
+      scheduleTaskNodes(readyNodes);
+
+      // Help executing the ready tasks while the queue is empty, otherwise wait for new tasks
+      if (executeReadyTaskNode())
+        continue;
+
+      if (queueShutdown)
       {
+        // Wait for the remaining tasks to complete
         for (; ;)
         {
-          if (task.ct && task.ct->isCancelled())
-            device->setAsyncError(Error::Cancelled, "execution was cancelled");
-          else
-            task.func();
+          const uint32_t completed = numCompleted.load();
+          {
+            std::lock_guard<std::mutex> lock(graphMutex);
+            if (taskNodes.empty())
+              return;
+          }
+          if (!executeReadyTaskNode())
+            numCompleted.wait(completed);
+        }
+      }
+
+      numPushed.wait(pushed);
+    }
+  }
 
-          task = {};
+  void CPUEngine::addTaskNode(Task&& task, std::vector<TaskNode*>& readyNodes)
+  {
+    taskNodes.emplace_back();
+    TaskNode* node = &taskNodes.back();
+    node->task = std::move(task);
+    const Task& curTask = node->task;
 
+    // Tasks with unknown accesses and joins depend on all preceding tasks
+    const bool isBarrier = curTask.join || !curTask.accesses;
+
+    // Add the dependencies on the preceding incomplete tasks, going backwards until the last
+    // barrier (which the earlier tasks are already ordered by), except for joins, which have to
+    // wait for the concurrent tasks before the barrier as well
+    for (auto it = std::next(taskNodes.rbegin()); it != taskNodes.rend(); ++it)
+    {
+      TaskNode* prevNode = &*it;
+      const Task& prevTask = prevNode->task;
+
+      // Only joins depend on concurrent tasks
+      if (!prevNode->done && (curTask.join || !prevTask.concurrent))
+      {
+        bool isDependent = isBarrier || !prevTask.accesses;
+        if (!isDependent)
+        {
+          // Check whether the tasks access overlapping memory, with at least one of them writing it
+          for (const MemoryAccess& a : *curTask.accesses)
           {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            queue.pop();
-            if (queue.empty())
+            for (const MemoryAccess& b : *prevTask.accesses)
+            {
+              if ((a.write || b.write) && a.begin < b.end && b.begin < a.end)
+              {
+                isDependent = true;
+                break;
+              }
+            }
+            if (isDependent)
               break;
-            task = std::move(queue.front());
           }
         }
 
-        queueCond.notify_all();
+        if (isDependent)
+        {
+          prevNode->successors.push_back(node);
+          node->numDeps++;
+        }
+      }
+
+      if (prevNode == lastBarrier && !curTask.join)
+        break;
+    }
+
+    // Concurrent tasks cannot be barriers because the next tasks do not depend on them
+    if (isBarrier && !curTask.concurrent)
+      lastBarrier = node;
+
+    if (node->numDeps == 0)
+      readyNodes.push_back(node);
+  }
+
+  void CPUEngine::scheduleTaskNodes(std::vector<TaskNode*>& nodes)
+  {
+    if (nodes.empty())
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock(graphMutex);
+      readyTaskNodes.insert(readyTaskNodes.end(), nodes.begin(), nodes.end());
+    }
+
+    // Enqueue a runner for each ready task, which executes the next ready task (if there is any
+    // left, as the queue thread may execute some of them too)
+    // Enqueued tasks are guaranteed to be executed even if the arena has no workers otherwise
+    numRunners += int(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      arena->enqueue([this]
+      {
+        TaskNode* node = popReadyTaskNode();
+        if (node)
+          executeTaskNode(node);
+        numRunners--; // the engine must not be accessed after this
       });
     }
+
+    nodes.clear();
+  }
+
+  CPUEngine::TaskNode* CPUEngine::popReadyTaskNode()
+  {
+    std::lock_guard<std::mutex> lock(graphMutex);
+    if (readyTaskNodes.empty())
+      return nullptr;
+    TaskNode* node = readyTaskNodes.front();
+    readyTaskNodes.pop_front();
+    return node;
+  }
+
+  bool CPUEngine::executeReadyTaskNode()
+  {
+    TaskNode* node = popReadyTaskNode();
+    if (!node)
+      return false;
+    arena->execute([&] { executeTaskNode(node); });
+    return true;
+  }
+
+  void CPUEngine::executeTaskNode(TaskNode* node)
+  {
+    Task& task = node->task;
+
+    if (task.ct && task.ct->isCancelled())
+      device->setAsyncError(Error::Cancelled, "execution was cancelled");
+    else if (task.func)
+    {
+      try
+      {
+        task.func();
+      }
+      catch (const Exception& e)
+      {
+        device->setAsyncError(e.code(), e.what());
+      }
+      catch (const std::exception& e)
+      {
+        device->setAsyncError(Error::Unknown, e.what());
+      }
+    }
+
+    completeTaskNode(node);
+  }
+
+  void CPUEngine::completeTaskNode(TaskNode* node)
+  {
+    std::vector<TaskNode*> readyNodes;
+    uint32_t numRetired = 0;
+
+    {
+      std::lock_guard<std::mutex> lock(graphMutex);
+      node->done = true;
+
+      for (TaskNode* successor : node->successors)
+      {
+        if (--successor->numDeps == 0)
+          readyNodes.push_back(successor);
+      }
+
+      // Retire the completed tasks from the beginning of the graph, so the completed tasks are
+      // always a prefix of the submitted tasks (required by wait())
+      while (!taskNodes.empty() && taskNodes.front().done)
+      {
+        if (&taskNodes.front() == lastBarrier)
+          lastBarrier = nullptr;
+        taskNodes.pop_front();
+        numRetired++;
+      }
+    }
+
+    // The node may have been retired already, so it must not be accessed anymore
+    scheduleTaskNodes(readyNodes);
+
+    if (numRetired > 0)
+      numCompleted.add(numRetired);
   }
 
 OIDN_NAMESPACE_END
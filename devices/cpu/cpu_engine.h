@@ -4,10 +4,12 @@
 #pragma once
 
 #include "core/engine.h"
+#include "common/mpsc_queue.h"
+#include "common/atomic_waitable.h"
 #include "cpu_device.h"
-#include <queue>
 #include <thread>
-#include <condition_variable>
+#include <list>
+#include <deque>
 
 OIDN_NAMESPACE_BEGIN
 
@@ -16,14 +18,25 @@ OIDN_NAMESPACE_BEGIN
     friend class CPUDevice;
 
   public:
-    CPUEngine(CPUDevice* device, int numThreads);
+    // If a NUMA node is specified, the threads are restricted to its CPUs and the allocated memory
+    // is first-touched on the node
+    // If there are multiple streams, the threads are divided evenly among them, and the engine
+    // uses the share of the specified stream
+    CPUEngine(CPUDevice* device, int numThreads, int numaNode = -1,
+              int stream = 0, int numStreams = 1);
     ~CPUEngine();
 
     Device* getDevice() const override { return device; }
-    int getNumThreads() const { return device->numThreads; }
+    int getNumThreads() const { return arena->max_concurrency(); }
+    const CPUCacheSizes& getCacheSizes() const { return device->getCacheSizes(); }
+    bool isConv2DBlockingEnabled() const { return device->isConv2DBlockingEnabled(); }
+    bool isConcatFusionEnabled()   const { return device->isConcatFusionEnabled(); }
 
     // Ops
   #if !defined(OIDN_DNNL) && !defined(OIDN_BNNS)
+    bool isBatchSupported() const override { return true; }
+    bool isPrecisionSupported(Precision precision) const override { return true; }
+    bool isConvSupported(const ConvDesc& desc) override;
     Ref<Conv> newConv(const ConvDesc& desc) override;
   #endif
     Ref<Pool> newPool(const PoolDesc& desc) override;
@@ -32,6 +45,12 @@ OIDN_NAMESPACE_BEGIN
     Ref<InputProcess> newInputProcess(const InputProcessDesc& desc) override;
     Ref<OutputProcess> newOutputProcess(const OutputProcessDesc& desc) override;
     Ref<ImageCopy> newImageCopy() override;
+    bool isTileVarianceSupported() const override { return true; }
+    Ref<TileVariance> newTileVariance() override;
+    Ref<TilePassThrough> newTilePassThrough(const TilePassThroughDesc& desc) override;
+
+    size_t submitDepthFirst(const std::vector<Ref<Op>>& ops, size_t begin, size_t end,
+                            const Ref<Progress>& progress) override;
 
     // Unified shared memory (USM)
     void* usmAlloc(size_t byteSize, Storage storage) override;
@@ -45,26 +64,83 @@ OIDN_NAMESPACE_BEGIN
     // Enqueues a host function
     void submitHostFunc(std::function<void()>&& f, const Ref<CancellationToken>& ct) override;
 
+    // Concurrent execution
+    bool isConcurrencySupported() const override { return device->isConcurrencyEnabled(); }
+    void beginConcurrent() override;
+    void endConcurrent() override;
+    void submitJoin() override;
+
+    // Dependency tracking
+  #if !defined(OIDN_DNNL) && !defined(OIDN_BNNS)
+    bool isDependencyTrackingSupported() const override
+    {
+      return device->isDependencyTrackingEnabled();
+    }
+  #endif
+    void beginAccesses(const std::vector<MemoryAccess>& accesses) override;
+    void endAccesses() override;
+
     void wait() override;
 
   protected:
+    using MemoryAccesses = std::vector<MemoryAccess>;
+
     struct Task
     {
       std::function<void()> func;
       Ref<CancellationToken> ct;
+      std::shared_ptr<const MemoryAccesses> accesses; // accessed memory, or null if unknown
+      bool concurrent; // runs concurrently with the next tasks in the queue until a join
+      bool join;       // waits for the concurrent tasks to complete
     };
 
+    // Task in the dependency graph, which can be executed when all tasks it depends on have
+    // been completed
+    struct TaskNode
+    {
+      Task task;
+      int numDeps = 0;                   // number of incomplete tasks this task depends on
+      std::vector<TaskNode*> successors; // tasks depending on this task
+      bool done = false;
+    };
+
+    static constexpr size_t queueCapacity = 1024;
+    static constexpr size_t maxNumGraphTasks = 256; // maximum number of tasks in the graph
+
+    void pushTask(Task&& task);
     void processQueue();
 
+    void addTaskNode(Task&& task, std::vector<TaskNode*>& readyNodes);
+    void scheduleTaskNodes(std::vector<TaskNode*>& nodes);
+    TaskNode* popReadyTaskNode();
+    bool executeReadyTaskNode();
+    void executeTaskNode(TaskNode* node);
+    void completeTaskNode(TaskNode* node);
+
     CPUDevice* device;
 
-    // Queue for executing functions asynchronously
-    std::queue<Task> queue;                    // queue of tasks to execute
-    bool queueShutdown = false;                // flag to signal the queue thread to shutdown
+    // Lock-free queue for executing functions asynchronously
+    // The submitting threads and the queue thread wait for each other with atomic counters, which
+    // require system calls only if a thread actually has to sleep
+    MPSCQueue<Task> queue{queueCapacity};      // queue of tasks to execute
+    AtomicWaitable numPushed;                  // number of tasks pushed to the queue
+    AtomicWaitable numCompleted;               // number of completed tasks (in submission order)
+    std::atomic<bool> queueShutdown{false};    // flag to signal the queue thread to shutdown
     std::thread queueThread;                   // thread that processes the queue
-    std::mutex queueMutex;                     // mutex for the queue
-    std::condition_variable queueCond;         // condition variable for the queue
-
+    bool concurrent = false;                   // submit functions as concurrent tasks
+    ThreadLocal<std::shared_ptr<const MemoryAccesses>> curAccesses; // declared accesses of the submitting threads
+
+    // The queue thread adds the tasks to a dependency graph, where each task depends on the
+    // preceding tasks accessing overlapping memory (at least one of them writing it), or on all
+    // preceding tasks if its accesses are unknown. Ready tasks are executed concurrently by
+    // runners enqueued to the arena, and by the queue thread while it is idle
+    std::mutex graphMutex;
+    std::list<TaskNode> taskNodes;             // tasks not retired yet, in submission order
+    std::deque<TaskNode*> readyTaskNodes;      // tasks ready for execution
+    TaskNode* lastBarrier = nullptr;           // last task depending on all preceding tasks
+    std::atomic<int> numRunners{0};            // number of enqueued task runners
+
+    int numaNode;                              // NUMA node of the engine, or -1 if not restricted
     std::shared_ptr<tbb::task_arena> arena;    // task arena where the functions are executed
     std::shared_ptr<PinningObserver> observer; // task scheduler observer for pinning threads
     std::shared_ptr<ThreadAffinity> affinity;  // thread affinity manager for pinning threads
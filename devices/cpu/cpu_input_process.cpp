@@ -10,7 +10,11 @@ OIDN_NAMESPACE_BEGIN
   CPUInputProcess::CPUInputProcess(CPUEngine* engine, const InputProcessDesc& desc)
     : InputProcess(engine, desc),
       engine(engine)
-  {}
+  {
+    if (dstDesc.dataType != DataType::Float32 && dstDesc.dataType != DataType::Float16 &&
+        dstDesc.dataType != DataType::UInt8)
+      throw std::invalid_argument("unsupported input processing destination data type");
+  }
 
   void CPUInputProcess::submitKernels(const Ref<CancellationToken>& ct)
   {
@@ -23,7 +27,11 @@ OIDN_NAMESPACE_BEGIN
     kernel.albedo = (color && albedo) ? *albedo : nullImage;
     kernel.normal = (color && normal) ? *normal : nullImage;
     kernel.dst    = *dst;
+    kernel.dstDataType = toISPC(dstDesc.dataType);
     kernel.tile   = toISPC(tile);
+    kernel.batchH = kernel.dst.H / batchSize;
+    kernel.batchCount = batchCount;
+    kernel.hSrcBatchStride = hSrcBatchStride;
     kernel.transferFunc = toISPC(*transferFunc);
     kernel.hdr   = hdr;
     kernel.snorm = snorm;
@@ -0,0 +1,72 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "cpu_int8_conv.h"
+#include "cpu_int8_conv_ispc.h"
+#include "cpu_common.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  CPUInt8Conv::CPUInt8Conv(CPUEngine* engine, const ConvDesc& desc)
+    : Conv(desc),
+      engine(engine)
+  {
+    if ((srcDesc.layout != TensorLayout::Chw8c &&
+         srcDesc.layout != TensorLayout::Chw16c) || srcDesc.dataType != DataType::UInt8)
+      throw std::invalid_argument("unsupported convolution source layout/data type");
+    if (weightDesc.getW() != 3 || weightDesc.getH() != 3)
+      throw std::invalid_argument("unsupported convolution kernel size");
+    if ((weightDesc.layout != TensorLayout::IOhw8i8o &&
+         weightDesc.layout != TensorLayout::IOhw16i16o) || weightDesc.dataType != DataType::Int8)
+      throw std::invalid_argument("unsupported convolution weight layout/data type");
+    if (biasDesc.layout != TensorLayout::x || biasDesc.dataType != DataType::Float32)
+      throw std::invalid_argument("unsupported convolution bias layout/data type");
+    if (dstDesc.dataType != DataType::UInt8 && dstDesc.dataType != DataType::Float32)
+      throw std::invalid_argument("unsupported convolution destination data type");
+    if (postOp != PostOp::None)
+      throw std::invalid_argument("unsupported convolution postop");
+    if (upsampleSrc || processDst)
+      throw std::invalid_argument("convolution upsampling/processing is not supported");
+
+    // The weights of 4 consecutive input channels are interleaved for the int8 dot products
+    weightDesc.layout = weightDesc.layout == TensorLayout::IOhw8i8o ? TensorLayout::IOhw2i8o4i
+                                                                    : TensorLayout::IOhw4i16o4i;
+  }
+
+  void CPUInt8Conv::submitKernels(const Ref<CancellationToken>& ct)
+  {
+    auto func = getBandFunc();
+    const int OH = dstDesc.getH();
+
+    engine->submitFunc([=] { func(0, OH); }, ct);
+  }
+
+  std::function<void(int hBegin, int hEnd)> CPUInt8Conv::getBandFunc()
+  {
+    if (!src || !dst)
+      throw std::logic_error("convolution source/destination not set");
+    if (!weightScale)
+      throw std::logic_error("convolution weight scale not set");
+
+    const int blockC = getTensorLayoutInfo(dstDesc.layout).blockC;
+
+    ispc::CPUInt8ConvKernel kernel;
+    kernel.src    = *src;
+    kernel.weight = *weight;
+    kernel.weightScale = *weightScale;
+    kernel.bias   = *bias;
+    kernel.dst    = *dst;
+    kernel.dstQuantized = dstDesc.dataType == DataType::UInt8;
+    kernel.batchH = dst->getH() / batchSize;
+    kernel.relu   = activation == Activation::ReLU;
+
+    return [=](int ohBegin, int ohEnd)
+    {
+      parallel_for(kernel.dst.C / blockC, ohEnd - ohBegin, [&](int ocb, int oh)
+      {
+        ispc::CPUInt8ConvKernel_run(&kernel, ocb, ohBegin + oh);
+      });
+    };
+  }
+
+OIDN_NAMESPACE_END
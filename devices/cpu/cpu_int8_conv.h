@@ -0,0 +1,30 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/conv.h"
+#include "cpu_engine.h"
+#include "cpu_band_op.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  // Quantized convolution with uint8 sources and int8 weights, which are dequantized with a scale
+  // for each output channel. The destination is either quantized (uint8) or floating-point
+  class CPUInt8Conv final : public Conv, public CPUBandOp
+  {
+  public:
+    CPUInt8Conv(CPUEngine* engine, const ConvDesc& desc);
+
+    Engine* getEngine() const override { return engine; }
+    void submitKernels(const Ref<CancellationToken>& ct) override;
+
+    TensorDesc getBandDstDesc() const override { return dstDesc; }
+    int getBandSrcH(int H) const override { return H + 1; } // KH = 3
+    std::function<void(int hBegin, int hEnd)> getBandFunc() override;
+
+  private:
+    CPUEngine* engine;
+  };
+
+OIDN_NAMESPACE_END
@@ -10,26 +10,43 @@ OIDN_NAMESPACE_BEGIN
   CPUOutputProcess::CPUOutputProcess(CPUEngine* engine, const OutputProcessDesc& desc)
     : OutputProcess(desc),
       engine(engine)
-  {}
+  {
+    if (srcDesc.dataType != DataType::Float32 && srcDesc.dataType != DataType::Float16)
+      throw std::invalid_argument("unsupported output processing source data type");
+  }
 
-  void CPUOutputProcess::submitKernels(const Ref<CancellationToken>& ct)
+  ispc::CPUOutputProcessKernel CPUOutputProcess::getKernel()
   {
-    check();
+    checkDst();
 
     ispc::CPUOutputProcessKernel kernel;
 
-    kernel.src = *src;
+    kernel.src = {}; // no source
+    if (src)
+      kernel.src = *src;
+    kernel.srcDataType = toISPC(srcDesc.dataType);
     kernel.dst = *dst;
     kernel.tile = toISPC(tile);
+    kernel.batchH = srcDesc.getH() / batchSize;
+    kernel.batchCount = batchCount;
+    kernel.hDstBatchStride = hDstBatchStride;
     kernel.transferFunc = toISPC(*transferFunc);
     kernel.hdr = hdr;
     kernel.snorm = snorm;
 
+    return kernel;
+  }
+
+  void CPUOutputProcess::submitKernels(const Ref<CancellationToken>& ct)
+  {
+    check();
+    const ispc::CPUOutputProcessKernel kernel = getKernel();
+
     engine->submitFunc([=]
     {
-      parallel_for(kernel.tile.H, [&](int h)
+      parallel_for(kernel.batchCount, kernel.tile.H, [&](int b, int h)
       {
-        ispc::CPUOutputProcessKernel_run(&kernel, h);
+        ispc::CPUOutputProcessKernel_run(&kernel, b, h);
       });
     }, ct);
   }
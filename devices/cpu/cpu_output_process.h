@@ -5,6 +5,7 @@
 
 #include "core/output_process.h"
 #include "cpu_engine.h"
+#include "cpu_output_process_ispc.h"
 
 OIDN_NAMESPACE_BEGIN
 
@@ -16,6 +17,10 @@ OIDN_NAMESPACE_BEGIN
     Engine* getEngine() const override { return engine; }
     void submitKernels(const Ref<CancellationToken>& ct) override;
 
+    // Returns the kernel for processing the current source, which can be used also by other
+    // kernels to process the source rows on the fly (the source may be null)
+    ispc::CPUOutputProcessKernel getKernel();
+
   private:
     CPUEngine* engine;
   };
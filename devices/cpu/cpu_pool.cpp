@@ -14,9 +14,20 @@ OIDN_NAMESPACE_BEGIN
     if (srcDesc.layout != TensorLayout::Chw8c &&
         srcDesc.layout != TensorLayout::Chw16c)
       throw std::invalid_argument("unsupported pooling source layout");
+    if (srcDesc.dataType != DataType::Float32 && srcDesc.dataType != DataType::Float16 &&
+        srcDesc.dataType != DataType::UInt8)
+      throw std::invalid_argument("unsupported pooling source data type");
   }
 
   void CPUPool::submitKernels(const Ref<CancellationToken>& ct)
+  {
+    auto func = getBandFunc();
+    const int H = dstDesc.getH();
+
+    engine->submitFunc([=] { func(0, H); }, ct);
+  }
+
+  std::function<void(int hBegin, int hEnd)> CPUPool::getBandFunc()
   {
     if (!src || !dst)
       throw std::logic_error("pooling source/destination not set");
@@ -26,14 +37,15 @@ OIDN_NAMESPACE_BEGIN
     ispc::CPUPoolKernel kernel;
     kernel.src = *src;
     kernel.dst = *dst;
+    kernel.dataType = toISPC(srcDesc.dataType);
 
-    engine->submitFunc([=]
+    return [=](int hBegin, int hEnd)
     {
-      parallel_for(kernel.dst.C / blockC, kernel.dst.H, [&](int cb, int h)
+      parallel_for(kernel.dst.C / blockC, hEnd - hBegin, [&](int cb, int h)
       {
-        ispc::CPUPoolKernel_run(&kernel, cb, h);
+        ispc::CPUPoolKernel_run(&kernel, cb, hBegin + h);
       });
-    }, ct);
+    };
   }
 
 OIDN_NAMESPACE_END
\ No newline at end of file
@@ -5,10 +5,11 @@
 
 #include "core/pool.h"
 #include "cpu_engine.h"
+#include "cpu_band_op.h"
 
 OIDN_NAMESPACE_BEGIN
 
-  class CPUPool final : public Pool
+  class CPUPool final : public Pool, public CPUBandOp
   {
   public:
     CPUPool(CPUEngine* engine, const PoolDesc& desc);
@@ -16,6 +17,10 @@ OIDN_NAMESPACE_BEGIN
     Engine* getEngine() const override { return engine; }
     void submitKernels(const Ref<CancellationToken>& ct) override;
 
+    TensorDesc getBandDstDesc() const override { return dstDesc; }
+    int getBandSrcH(int H) const override { return H * 2; }
+    std::function<void(int hBegin, int hEnd)> getBandFunc() override;
+
   private:
     CPUEngine* engine;
   };
@@ -0,0 +1,39 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "cpu_tile_pass_through.h"
+#include "cpu_tile_pass_through_ispc.h"
+#include "cpu_common.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  CPUTilePassThrough::CPUTilePassThrough(CPUEngine* engine, const TilePassThroughDesc& desc)
+    : TilePassThrough(desc),
+      engine(engine)
+  {}
+
+  void CPUTilePassThrough::submitKernels(const Ref<CancellationToken>& ct)
+  {
+    check();
+
+    ispc::CPUTilePassThroughKernel kernel;
+    kernel.src = *src;
+    kernel.dst = *dst;
+    kernel.tile = toISPC(tile);
+    kernel.hBatchStride = hBatchStride;
+    kernel.transferFunc = toISPC(*transferFunc);
+    kernel.hdr = hdr;
+    kernel.snorm = snorm;
+
+    const int batchCount = this->batchCount;
+
+    engine->submitFunc([=]
+    {
+      parallel_for(batchCount, kernel.tile.H, [&](int b, int h)
+      {
+        ispc::CPUTilePassThroughKernel_run(&kernel, b, h);
+      });
+    }, ct);
+  }
+
+OIDN_NAMESPACE_END
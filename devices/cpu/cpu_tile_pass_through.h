@@ -0,0 +1,23 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/tile_pass_through.h"
+#include "cpu_engine.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  class CPUTilePassThrough final : public TilePassThrough
+  {
+  public:
+    CPUTilePassThrough(CPUEngine* engine, const TilePassThroughDesc& desc);
+
+    Engine* getEngine() const override { return engine; }
+    void submitKernels(const Ref<CancellationToken>& ct) override;
+
+  private:
+    CPUEngine* engine;
+  };
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,126 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "cpu_tile_variance.h"
+#include "cpu_tile_variance_ispc.h"
+#include "cpu_common.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  namespace
+  {
+    // Per-channel mean and sum of squared differences from the mean of a set of pixels
+    struct Stats
+    {
+      static constexpr int maxC = 9; // color, albedo, normal
+
+      double n = 0;
+      double mean[maxC] = {};
+      double M2[maxC] = {};
+    };
+
+    // Merges the statistics of two disjoint sets of pixels (Chan et al.)
+    Stats mergeStats(const Stats& a, const Stats& b)
+    {
+      if (a.n == 0)
+        return b;
+      if (b.n == 0)
+        return a;
+
+      Stats s;
+      s.n = a.n + b.n;
+      for (int c = 0; c < Stats::maxC; ++c)
+      {
+        const double delta = b.mean[c] - a.mean[c];
+        s.mean[c] = a.mean[c] + delta * (b.n / s.n);
+        s.M2[c] = a.M2[c] + b.M2[c] + delta * delta * (a.n * b.n / s.n);
+      }
+      return s;
+    }
+  }
+
+  CPUTileVariance::CPUTileVariance(CPUEngine* engine)
+    : engine(engine)
+  {}
+
+  void CPUTileVariance::submitKernels(const Ref<CancellationToken>& ct)
+  {
+    check();
+
+    ispc::ImageAccessor srcAccs[3];
+    int numSrcs = 0;
+    for (const auto& src : {color, albedo, normal})
+    {
+      if (src)
+        srcAccs[numSrcs++] = *src;
+    }
+
+    const Tile tile = this->tile;
+    const int batchCount = this->batchCount;
+    const int hSrcBatchStride = this->hSrcBatchStride;
+    float* dstPtr = getDstPtr();
+
+    engine->submitFunc([=]()
+    {
+      // Divide the tile into bins in each image
+      const int numBinsH = ceil_div(tile.H, maxBinSize);
+      const int numBinsW = ceil_div(tile.W, maxBinSize);
+
+      const Stats stats =
+        tbb::parallel_deterministic_reduce(
+          tbb::blocked_range2d<int>(0, batchCount * numBinsH, 0, numBinsW),
+          Stats(),
+          [&](const tbb::blocked_range2d<int>& r, Stats stats) -> Stats
+          {
+            // Iterate over bins
+            for (int i = r.rows().begin(); i != r.rows().end(); ++i)
+            {
+              const int b = i / numBinsH;
+              const int binH = i % numBinsH;
+              const int hOffset = tile.hSrcBegin + b * hSrcBatchStride;
+
+              for (int j = r.cols().begin(); j != r.cols().end(); ++j)
+              {
+                const int beginH = hOffset + int(ptrdiff_t(binH)   * tile.H / numBinsH);
+                const int endH   = hOffset + int(ptrdiff_t(binH+1) * tile.H / numBinsH);
+                const int beginW = tile.wSrcBegin + int(ptrdiff_t(j)   * tile.W / numBinsW);
+                const int endW   = tile.wSrcBegin + int(ptrdiff_t(j+1) * tile.W / numBinsW);
+
+                // Compute the statistics of all channels in the current bin
+                Stats binStats;
+                binStats.n = double(endH - beginH) * (endW - beginW);
+
+                for (int k = 0; k < numSrcs; ++k)
+                {
+                  float mean[3], M2[3];
+                  ispc::tileVarianceBin(srcAccs[k], beginH, endH, beginW, endW, mean, M2);
+                  for (int c = 0; c < 3; ++c)
+                  {
+                    binStats.mean[k*3+c] = mean[c];
+                    binStats.M2[k*3+c]   = M2[c];
+                  }
+                }
+
+                stats = mergeStats(stats, binStats);
+              }
+            }
+
+            return stats;
+          },
+          [](const Stats& a, const Stats& b) -> Stats { return mergeStats(a, b); }
+        );
+
+      // Get the maximum variance, keeping NaNs
+      float maxVariance = 0.f;
+      for (int c = 0; c < numSrcs * 3; ++c)
+      {
+        const float variance = float(stats.M2[c] / stats.n);
+        if (math::isnan(variance) || variance > maxVariance)
+          maxVariance = variance;
+      }
+
+      *dstPtr = maxVariance;
+    }, ct);
+  }
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,23 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/tile_variance.h"
+#include "cpu_engine.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  class CPUTileVariance final : public TileVariance
+  {
+  public:
+    explicit CPUTileVariance(CPUEngine* engine);
+
+    Engine* getEngine() const override { return engine; }
+    void submitKernels(const Ref<CancellationToken>& ct) override;
+
+  private:
+    CPUEngine* engine;
+  };
+
+OIDN_NAMESPACE_END
@@ -15,6 +15,10 @@ OIDN_NAMESPACE_BEGIN
         srcDesc.layout != TensorLayout::Chw8c &&
         srcDesc.layout != TensorLayout::Chw16c)
       throw std::invalid_argument("unsupported upsampling source layout");
+    if (srcDesc.dataType != DataType::Float32 &&
+        ((srcDesc.dataType != DataType::Float16 && srcDesc.dataType != DataType::UInt8) ||
+         srcDesc.layout == TensorLayout::chw))
+      throw std::invalid_argument("unsupported upsampling source data type");
   }
 
   void CPUUpsample::submitKernels(const Ref<CancellationToken>& ct)
@@ -29,6 +33,7 @@ OIDN_NAMESPACE_BEGIN
       ispc::CPUUpsampleKernel kernel;
       kernel.src = *src;
       kernel.dst = *dst;
+      kernel.dataType = toISPC(srcDesc.dataType);
 
       engine->submitFunc([=]
       {
@@ -0,0 +1,121 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "cpu_winograd_conv.h"
+#include "cpu_winograd_conv_ispc.h"
+#include "cpu_common.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  CPUWinogradConv::CPUWinogradConv(CPUEngine* engine, const ConvDesc& desc)
+    : Conv(desc),
+      engine(engine)
+  {
+    if ((srcDesc.layout != TensorLayout::Chw8c &&
+         srcDesc.layout != TensorLayout::Chw16c) ||
+        (srcDesc.dataType != DataType::Float32 && srcDesc.dataType != DataType::Float16))
+      throw std::invalid_argument("unsupported convolution source layout/data type");
+    if (weightDesc.getW() != 3 || weightDesc.getH() != 3)
+      throw std::invalid_argument("unsupported convolution kernel size");
+    if ((weightDesc.layout != TensorLayout::IOhw8i8o &&
+         weightDesc.layout != TensorLayout::IOhw16i16o) || weightDesc.dataType != DataType::Float32)
+      throw std::invalid_argument("unsupported convolution weight layout/data type");
+    if (biasDesc.layout != TensorLayout::x || biasDesc.dataType != DataType::Float32)
+      throw std::invalid_argument("unsupported convolution bias layout/data type");
+    if (postOp != PostOp::None)
+      throw std::invalid_argument("unsupported convolution postop");
+    if (upsampleSrc || processDst)
+      throw std::invalid_argument("convolution upsampling/processing is not supported");
+
+    // The weights are transformed ahead of time (6x6 per input/output channel pair)
+    const int WS = tileSize + 2; // transformed tile size
+    weightDesc = {{weightDesc.getO(),       weightDesc.getI(),       WS, WS},
+                  {weightDesc.getPaddedO(), weightDesc.getPaddedI(), WS, WS},
+                  weightDesc.layout == TensorLayout::IOhw8i8o ? TensorLayout::WIOhw8i8o
+                                                              : TensorLayout::WIOhw16i16o,
+                  weightDesc.dataType};
+
+    blockTW = ispc::CPUWinogradConvKernel_getBlockTW();
+    threadScratchByteSize =
+      round_up(ispc::CPUWinogradConvKernel_getScratchByteSize(srcDesc.getPaddedC()), memoryAlignment);
+  }
+
+  size_t CPUWinogradConv::getScratchByteSize()
+  {
+    return threadScratchByteSize * engine->getNumThreads();
+  }
+
+  void CPUWinogradConv::setScratch(const Ref<Buffer>& scratch)
+  {
+    if (scratch->getByteSize() < getScratchByteSize())
+      throw std::invalid_argument("convolution scratch buffer is too small");
+    this->scratch = scratch;
+  }
+
+  void CPUWinogradConv::submitKernels(const Ref<CancellationToken>& ct)
+  {
+    auto func = getBandFunc();
+    const int OH = dstDesc.getH();
+
+    engine->submitFunc([=] { func(0, OH); }, ct);
+  }
+
+  int CPUWinogradConv::getBandSrcH(int H) const
+  {
+    // Whole output tiles are computed, which read one more source row than they output (KH = 3),
+    // but the tiles do not cross the images in the batch
+    const int batchH = dstDesc.getH() / batchSize;
+    const int b  = (H - 1) / batchH; // image of the last row
+    const int bh = H - b * batchH;   // number of rows in the last image
+    return b * batchH + min(round_up(bh, tileSize) + 1, batchH);
+  }
+
+  std::function<void(int hBegin, int hEnd)> CPUWinogradConv::getBandFunc()
+  {
+    if (!src || !dst)
+      throw std::logic_error("convolution source/destination not set");
+    if (!scratch)
+      throw std::logic_error("convolution scratch not set");
+
+    ispc::CPUWinogradConvKernel kernel;
+    kernel.src    = *src;
+    kernel.weight = *weight;
+    kernel.bias   = *bias;
+    kernel.dst    = *dst;
+    kernel.dataType = toISPC(srcDesc.dataType);
+    kernel.batchH = dst->getH() / batchSize;
+    kernel.relu   = activation == Activation::ReLU;
+
+    uint8_t* scratchPtr = static_cast<uint8_t*>(scratch->getPtr());
+    const size_t threadScratchByteSize = this->threadScratchByteSize;
+    const int blockTW = this->blockTW;
+
+    return [=](int ohBegin, int ohEnd)
+    {
+      const int batchH = kernel.batchH;
+      const int TH  = ceil_div(batchH, tileSize);     // number of tile rows per image
+      const int TW  = ceil_div(kernel.dst.W, tileSize); // number of tiles per row
+      const int TWB = ceil_div(TW, blockTW);          // number of tile blocks per row
+
+      // Tile rows (over all images in the batch) which intersect the range of output rows
+      const int thBegin = (ohBegin / batchH) * TH + (ohBegin % batchH) / tileSize;
+      const int thEnd   = ((ohEnd-1) / batchH) * TH + ((ohEnd-1) % batchH) / tileSize + 1;
+      const size_t N = size_t(thEnd - thBegin) * TWB;
+
+      parallel_for(N, [&](size_t i)
+      {
+        const int th  = thBegin + int(i / TWB);
+        const int twb = int(i % TWB);
+        const int twBegin = twb * blockTW;
+        const int twEnd   = min(twBegin + blockTW, TW);
+
+        const int threadIndex = tbb::this_task_arena::current_thread_index();
+        uint8_t* threadScratchPtr = scratchPtr + size_t(threadIndex) * threadScratchByteSize;
+
+        ispc::CPUWinogradConvKernel_run(&kernel, threadScratchPtr, th / TH, th % TH, twBegin, twEnd,
+                                        ohBegin, ohEnd);
+      });
+    };
+  }
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,51 @@
+// Copyright 2025 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/conv.h"
+#include "cpu_engine.h"
+#include "cpu_band_op.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  // Winograd F(4x4,3x3) convolution, which is faster than direct convolution but slightly less
+  // accurate, so it is used only if fast math is enabled
+  class CPUWinogradConv final : public Conv, public CPUBandOp
+  {
+  public:
+    CPUWinogradConv(CPUEngine* engine, const ConvDesc& desc);
+
+    Engine* getEngine() const override { return engine; }
+
+    size_t getScratchByteSize() override;
+    void setScratch(const Ref<Buffer>& scratch) override;
+
+    bool getAccesses(std::vector<MemoryAccess>& accesses) const override
+    {
+      // Only the op scratch at the beginning of the scratch buffer is used (the graph may store
+      // tensors after it)
+      if (scratch)
+      {
+        const size_t opScratchByteSize = threadScratchByteSize * engine->getNumThreads();
+        addAccess(accesses, scratch->getPtr(), opScratchByteSize, true);
+      }
+      return Conv::getAccesses(accesses);
+    }
+
+    void submitKernels(const Ref<CancellationToken>& ct) override;
+
+    TensorDesc getBandDstDesc() const override { return dstDesc; }
+    int getBandSrcH(int H) const override;
+    std::function<void(int hBegin, int hEnd)> getBandFunc() override;
+
+  private:
+    static constexpr int tileSize = 4; // output tile size
+
+    CPUEngine* engine;
+    int blockTW;                   // block of output tiles in the width dimension
+    size_t threadScratchByteSize;  // scratch size per thread
+    Ref<Buffer> scratch;
+  };
+
+OIDN_NAMESPACE_END
@@ -11,7 +11,7 @@ OIDN_NAMESPACE_BEGIN
   class DNNLEngine final : public CPUEngine
   {
   public:
-    DNNLEngine(CPUDevice* device, int numThreads);
+    DNNLEngine(CPUDevice* device, int numThreads, int stream = 0, int numStreams = 1);
 
     oidn_inline dnnl::engine& getDNNLEngine() { return dnnlEngine; }
     oidn_inline dnnl::stream& getDNNLStream() { return dnnlStream; }
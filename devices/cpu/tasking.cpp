@@ -15,9 +15,11 @@ OIDN_NAMESPACE_BEGIN
     observe(true);
   }
 
-  PinningObserver::PinningObserver(const std::shared_ptr<ThreadAffinity>& affinity, tbb::task_arena& arena)
+  PinningObserver::PinningObserver(const std::shared_ptr<ThreadAffinity>& affinity, tbb::task_arena& arena,
+                                   int threadOffset)
     : tbb::task_scheduler_observer(arena),
-      affinity(affinity)
+      affinity(affinity),
+      threadOffset(threadOffset)
   {
     observe(true);
   }
@@ -31,14 +33,14 @@ OIDN_NAMESPACE_BEGIN
   {
     const int threadIndex = tbb::this_task_arena::current_thread_index();
     if (threadIndex >= 0)
-      affinity->set(threadIndex);
+      affinity->set(threadOffset + threadIndex);
   }
 
   void PinningObserver::on_scheduler_exit(bool isWorker)
   {
     const int threadIndex = tbb::this_task_arena::current_thread_index();
     if (threadIndex >= 0)
-      affinity->restore(threadIndex);
+      affinity->restore(threadOffset + threadIndex);
   }
 
 OIDN_NAMESPACE_END
@@ -45,7 +45,9 @@ OIDN_NAMESPACE_BEGIN
   {
   public:
     explicit PinningObserver(const std::shared_ptr<ThreadAffinity>& affinity);
-    PinningObserver(const std::shared_ptr<ThreadAffinity>& affinity, tbb::task_arena& arena);
+    // The threads of the arena are pinned starting from the specified thread affinity index
+    PinningObserver(const std::shared_ptr<ThreadAffinity>& affinity, tbb::task_arena& arena,
+                    int threadOffset = 0);
     ~PinningObserver();
 
     void on_scheduler_entry(bool isWorker) override;
@@ -53,6 +55,7 @@ OIDN_NAMESPACE_BEGIN
 
   private:
     std::shared_ptr<ThreadAffinity> affinity;
+    int threadOffset = 0;
   };
 
   // -----------------------------------------------------------------------------------------------
@@ -104,11 +104,12 @@ OIDN_NAMESPACE_BEGIN
       return makeRef<DeviceTensor>(buffer, desc, byteOffset);
   }
 
-  bool MetalEngine::isConvSupported(PostOp postOp)
+  bool MetalEngine::isConvSupported(const ConvDesc& desc)
   {
-    return postOp == PostOp::None ||
-           postOp == PostOp::Pool ||
-           postOp == PostOp::Upsample;
+    return (desc.postOp == PostOp::None ||
+            desc.postOp == PostOp::Pool ||
+            desc.postOp == PostOp::Upsample) && !desc.upsampleSrc &&
+           !desc.processDst;
   }
 
   Ref<Conv> MetalEngine::newConv(const ConvDesc& desc)
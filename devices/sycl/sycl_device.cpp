@@ -431,7 +431,7 @@ OIDN_NAMESPACE_BEGIN
     }
   }
 
-  void SYCLDevice::submitBarrier()
+  void SYCLDevice::submitBarrier(int stream)
   {
     // We need a barrier only if there are at least 2 subdevices
     const int numSubdevices = getNumSubdevices();
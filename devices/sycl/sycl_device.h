@@ -52,7 +52,7 @@ OIDN_NAMESPACE_BEGIN
 
     Storage getPtrStorage(const void* ptr) override;
 
-    void submitBarrier() override;
+    void submitBarrier(int stream) override;
     void wait() override;
 
     // Manually sets the dependent events for the next command on all engines
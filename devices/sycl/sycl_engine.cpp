@@ -36,11 +36,12 @@ OIDN_NAMESPACE_BEGIN
     return makeRef<SYCLExternalBuffer>(this, handleType, handle, name, byteSize);
   }
 
-  bool SYCLEngine::isConvSupported(PostOp postOp)
+  bool SYCLEngine::isConvSupported(const ConvDesc& desc)
   {
-    return postOp == PostOp::None ||
-           postOp == PostOp::Pool ||
-           postOp == PostOp::Upsample;
+    return (desc.postOp == PostOp::None ||
+            desc.postOp == PostOp::Pool ||
+            desc.postOp == PostOp::Upsample) && !desc.upsampleSrc &&
+           !desc.processDst;
   }
 
   Ref<Conv> SYCLEngine::newConv(const ConvDesc& desc)
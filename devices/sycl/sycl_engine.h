@@ -34,7 +34,7 @@ OIDN_NAMESPACE_BEGIN
                                   void* handle, const void* name, size_t byteSize) override;
 
     // Ops
-    bool isConvSupported(PostOp postOp) override;
+    bool isConvSupported(const ConvDesc& desc) override;
     Ref<Conv> newConv(const ConvDesc& desc) override;
     Ref<Pool> newPool(const PoolDesc& desc) override;
     Ref<Upsample> newUpsample(const UpsampleDesc& desc) override;
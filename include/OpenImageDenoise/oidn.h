@@ -386,6 +386,14 @@ typedef enum
   OIDN_QUALITY_HIGH     = 6, // high quality (for final-frame rendering)
 } OIDNQuality;
 
+// Filter inference precision modes
+typedef enum
+{
+  OIDN_PRECISION_DEFAULT = 0, // default precision of the device
+  OIDN_PRECISION_INT8    = 1, // quantized int8 inference (requires calibrated weights)
+  OIDN_PRECISION_FP16    = 2, // half-precision activations (lower memory usage)
+} OIDNPrecision;
+
 // Progress monitor callback function
 typedef bool (*OIDNProgressMonitorFunction)(void* userPtr, double n);
 
@@ -496,6 +504,13 @@ inline float oidnGetFilter1f(OIDNFilter filter, const char* name)
   return oidnGetFilterFloat(filter, name);
 }
 
+// Sets a string parameter of the filter. Setting it to NULL or an empty string unsets it.
+OIDN_API void oidnSetFilterString(OIDNFilter filter, const char* name, const char* value);
+
+// Gets a string parameter of the filter. The returned pointer is valid until the parameter is
+// changed or the filter is released.
+OIDN_API const char* oidnGetFilterString(OIDNFilter filter, const char* name);
+
 // Sets the progress monitor callback function of the filter.
 OIDN_API void oidnSetFilterProgressMonitorFunction(OIDNFilter filter,
                                                    OIDNProgressMonitorFunction func, void* userPtr);
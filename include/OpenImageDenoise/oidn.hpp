@@ -328,6 +328,14 @@ OIDN_NAMESPACE_BEGIN
     High     = OIDN_QUALITY_HIGH,     // high quality (for final-frame rendering)
   };
 
+  // Filter inference precision modes
+  enum class Precision
+  {
+    Default = OIDN_PRECISION_DEFAULT, // default precision of the device
+    Int8    = OIDN_PRECISION_INT8,    // quantized int8 inference (requires calibrated weights)
+    FP16    = OIDN_PRECISION_FP16,    // half-precision activations (lower memory usage)
+  };
+
   // Progress monitor callback function
   using ProgressMonitorFunction = OIDNProgressMonitorFunction;
 
@@ -485,12 +493,28 @@ OIDN_NAMESPACE_BEGIN
       oidnSetFilterInt(handle, name, static_cast<int>(value));
     }
 
+    void set(const char* name, Precision value)
+    {
+      oidnSetFilterInt(handle, name, static_cast<int>(value));
+    }
+
     // Sets a float parameter of the filter.
     void set(const char* name, float value)
     {
       oidnSetFilterFloat(handle, name, value);
     }
 
+    // Sets a string parameter of the filter.
+    void set(const char* name, const char* value)
+    {
+      oidnSetFilterString(handle, name, value);
+    }
+
+    void set(const char* name, const std::string& value)
+    {
+      oidnSetFilterString(handle, name, value.c_str());
+    }
+
     // Gets a parameter of the filter.
     template<typename T>
     T get(const char* name) const;
@@ -552,12 +576,31 @@ OIDN_NAMESPACE_BEGIN
     return static_cast<Quality>(oidnGetFilterInt(handle, name));
   }
 
+  template<>
+  inline Precision FilterRef::get(const char* name) const
+  {
+    return static_cast<Precision>(oidnGetFilterInt(handle, name));
+  }
+
   template<>
   inline float FilterRef::get(const char* name) const
   {
     return oidnGetFilterFloat(handle, name);
   }
 
+  template<>
+  inline const char* FilterRef::get(const char* name) const
+  {
+    return oidnGetFilterString(handle, name);
+  }
+
+  template<>
+  inline std::string FilterRef::get(const char* name) const
+  {
+    const char* str = oidnGetFilterString(handle, name);
+    return str ? str : "";
+  }
+
   // -----------------------------------------------------------------------------------------------
   // Device
   // -----------------------------------------------------------------------------------------------
@@ -20,6 +20,7 @@ MODELS = [
 parser = argparse.ArgumentParser(description='Builds the weights blobs from the training results.')
 parser.usage = '\rIntel(R) Open Image Denoise - Build Weights\n' + parser.format_usage()
 parser.add_argument('--results_dir', '-R', type=str, default=os.path.join(root_dir, 'training', 'results'), help='directory of training results')
+parser.add_argument('--layouts', type=str, nargs='*', default=[], help='additional pre-reordered weight layouts (e.g. OIhw16i16o)')
 cfg = parser.parse_args()
 
 weights_dir = os.path.join(root_dir, 'weights')
@@ -28,5 +29,6 @@ export_cmd = os.path.join(root_dir, 'training', 'export.py')
 # Export the weights blobs
 for model in MODELS:
   tza_filename = os.path.join(weights_dir, model + '.tza')
-  run(export_cmd + f' -R {cfg.results_dir} -r {model} -o {tza_filename}')
+  layouts_args = (' --layouts ' + ' '.join(cfg.layouts)) if cfg.layouts else ''
+  run(export_cmd + f' -R {cfg.results_dir} -r {model} -o {tza_filename}' + layouts_args)
   print()
\ No newline at end of file
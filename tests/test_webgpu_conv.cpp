@@ -81,7 +81,7 @@ TEST(WebGPU, Conv2d)
     reorderWeight(*weightSrc, *weightTensor);
     reorderBias(*biasSrc, *biasTensor);
 
-    auto convCPU = cpuEng->newConv({srcDesc, weightDesc, biasDesc, Activation::ReLU, PostOp::None, false});
+    auto convCPU = cpuEng->newConv({srcDesc, weightDesc, biasDesc, Activation::ReLU, PostOp::None, false, 1, DataType::Float32, false, false});
     convCPU->setSrc(srcTensor);
     convCPU->setWeight(weightTensor);
     convCPU->setBias(biasTensor);
@@ -146,7 +146,7 @@ TEST(WebGPU, Conv2d)
   auto wTensorGPU   = eng->Engine::newTensor(Ref<Buffer>(reinterpret_cast<Buffer*>(wBuf.getHandle())), wDescGPU);
   auto bTensorGPU   = eng->Engine::newTensor(Ref<Buffer>(reinterpret_cast<Buffer*>(bBuf.getHandle())), bDescGPU);
 
-  auto conv = eng->newConv({srcDescGPU, wDescGPU, bDescGPU, Activation::ReLU, PostOp::None, false});
+  auto conv = eng->newConv({srcDescGPU, wDescGPU, bDescGPU, Activation::ReLU, PostOp::None, false, 1, DataType::Float32, false, false});
   conv->setSrc(srcTensorGPU);
   conv->setWeight(wTensorGPU);
   conv->setBias(bTensorGPU);
@@ -34,7 +34,7 @@ TEST(WebGPU, InputProcess)
     CPUEngine* cpuEng = static_cast<CPUEngine*>(cpuImpl->getEngine());
     TensorDims dims{3,int(H),int(W)};
     auto tf = std::make_shared<TransferFunction>(TransferFunction::Type::Linear);
-    auto proc = cpuEng->newInputProcess({dims, tf, false, false});
+    auto proc = cpuEng->newInputProcess({dims, 1, tf, false, false, cpuImpl->getTensorDataType()});
     auto colorImg = makeRef<Image>(color, Format::Float3, W, H, 0, sizeof(float)*3, sizeof(float)*3*W);
     proc->setSrc(colorImg, nullptr, nullptr);
     proc->setTile(0, 0, 0, 0, H, W);
@@ -63,7 +63,7 @@ TEST(WebGPU, InputProcess)
 
   TensorDims dims{3,int(H),int(W)};
   auto tf = std::make_shared<TransferFunction>(TransferFunction::Type::Linear);
-  auto proc = eng->newInputProcess({dims, tf, false, false});
+  auto proc = eng->newInputProcess({dims, 1, tf, false, false, eng->getDevice()->getTensorDataType()});
   auto colorImg = makeRef<Image>(color, Format::Float3, W, H, 0, sizeof(float)*3, sizeof(float)*3*W);
   proc->setSrc(colorImg, nullptr, nullptr);
   proc->setTile(0, 0, 0, 0, H, W);
@@ -115,7 +115,7 @@ TEST(WebGPU, InputProcessAdvanced)
     CPUEngine* cpuEng = static_cast<CPUEngine*>(cpuImpl->getEngine());
     TensorDims dims{9,int(H),int(W)};
     auto tf = std::make_shared<TransferFunction>(TransferFunction::Type::SRGB);
-    auto proc = cpuEng->newInputProcess({dims, tf, true, true});
+    auto proc = cpuEng->newInputProcess({dims, 1, tf, true, true, cpuImpl->getTensorDataType()});
     auto colorImg = makeRef<Image>(color, Format::Float3, W, H, 0, sizeof(float)*3, sizeof(float)*3*W);
     auto albedoImg = makeRef<Image>(albedo, Format::Float3, W, H, 0, sizeof(float)*3, sizeof(float)*3*W);
     auto normalImg = makeRef<Image>(normal, Format::Float3, W, H, 0, sizeof(float)*3, sizeof(float)*3*W);
@@ -146,7 +146,7 @@ TEST(WebGPU, InputProcessAdvanced)
 
   TensorDims dims{9,int(H),int(W)};
   auto tf = std::make_shared<TransferFunction>(TransferFunction::Type::SRGB);
-  auto proc = eng->newInputProcess({dims, tf, true, true});
+  auto proc = eng->newInputProcess({dims, 1, tf, true, true, eng->getDevice()->getTensorDataType()});
   auto colorImg = makeRef<Image>(color, Format::Float3, W, H, 0, sizeof(float)*3, sizeof(float)*3*W);
   auto albedoImg = makeRef<Image>(albedo, Format::Float3, W, H, 0, sizeof(float)*3, sizeof(float)*3*W);
   auto normalImg = makeRef<Image>(normal, Format::Float3, W, H, 0, sizeof(float)*3, sizeof(float)*3*W);
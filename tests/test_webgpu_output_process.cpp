@@ -51,7 +51,7 @@ TEST(WebGPU, OutputProcess)
           }
     };
     pack(srcData, static_cast<float*>(srcTensor->getPtr()));
-    auto proc = cpuEng->newOutputProcess({srcDesc, std::make_shared<TransferFunction>(TransferFunction::Type::Linear), false, false});
+    auto proc = cpuEng->newOutputProcess({srcDesc, 1, std::make_shared<TransferFunction>(TransferFunction::Type::Linear), false, false});
     proc->setSrc(srcTensor);
     auto dstImg = makeRef<Image>(refImg, Format::Float3, W, H, 0, sizeof(float)*3, sizeof(float)*3*W);
     proc->setDst(dstImg);
@@ -73,7 +73,7 @@ TEST(WebGPU, OutputProcess)
   auto srcBuf = dev.newBuffer(sizeof(srcDataGPU));
   srcBuf.write(0, sizeof(srcDataGPU), srcDataGPU);
   auto srcTensorGPU = eng->Engine::newTensor(Ref<Buffer>(reinterpret_cast<Buffer*>(srcBuf.getHandle())), srcDescGPU);
-  auto proc = eng->newOutputProcess({srcDescGPU, std::make_shared<TransferFunction>(TransferFunction::Type::Linear), false, false});
+  auto proc = eng->newOutputProcess({srcDescGPU, 1, std::make_shared<TransferFunction>(TransferFunction::Type::Linear), false, false});
   proc->setSrc(srcTensorGPU);
   float outImg[H*W*3];
   auto dstImgGPU = makeRef<Image>(outImg, Format::Float3, W, H, 0, sizeof(float)*3, sizeof(float)*3*W);
@@ -127,7 +127,7 @@ TEST(WebGPU, OutputProcessAdvanced)
           }
     };
     pack(srcData, static_cast<float*>(srcTensor->getPtr()));
-    auto proc = cpuEng->newOutputProcess({srcDesc, std::make_shared<TransferFunction>(TransferFunction::Type::SRGB), true, true});
+    auto proc = cpuEng->newOutputProcess({srcDesc, 1, std::make_shared<TransferFunction>(TransferFunction::Type::SRGB), true, true});
     proc->setSrc(srcTensor);
     auto dstImg = makeRef<Image>(refImg, Format::Float3, W, H, 0, sizeof(float)*3, sizeof(float)*3*W);
     proc->setDst(dstImg);
@@ -145,7 +145,7 @@ TEST(WebGPU, OutputProcessAdvanced)
   auto srcBuf = dev.newBuffer(sizeof(srcDataGPU));
   srcBuf.write(0, sizeof(srcDataGPU), srcDataGPU);
   auto srcTensorGPU = eng->Engine::newTensor(Ref<Buffer>(reinterpret_cast<Buffer*>(srcBuf.getHandle())), srcDescGPU);
-  auto proc = eng->newOutputProcess({srcDescGPU, std::make_shared<TransferFunction>(TransferFunction::Type::SRGB), true, true});
+  auto proc = eng->newOutputProcess({srcDescGPU, 1, std::make_shared<TransferFunction>(TransferFunction::Type::SRGB), true, true});
   proc->setSrc(srcTensorGPU);
   float outImg[H*W*3];
   auto dstImgGPU = makeRef<Image>(outImg, Format::Float3, W, H, 0, sizeof(float)*3, sizeof(float)*3*W);
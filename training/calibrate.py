@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+
+## Copyright 2025 Intel Corporation
+## SPDX-License-Identifier: Apache-2.0
+
+import os
+import numpy as np
+import torch
+
+from config import *
+from util import *
+from dataset import *
+from model import *
+from result import *
+from infer import Infer
+import tza
+
+# Records the maximum (or a high percentile) of the activations of each convolution
+class ActivationObserver(object):
+  def __init__(self, model, percentile):
+    self.percentile = percentile
+    self.ranges = {}
+    self.conv_names = []
+    self._hooks = []
+
+    for name, module in model.named_modules():
+      if isinstance(module, nn.Conv2d):
+        self.conv_names.append(name)
+        self._hooks.append(module.register_forward_hook(self._get_hook(name)))
+
+  def _get_hook(self, name):
+    def hook(module, input, output):
+      # All convolutions are followed by ReLU
+      x = torch.clamp(output.detach().float(), min=0.).flatten()
+      if self.percentile < 100.:
+        # Estimate the percentile from a random subset of the values
+        if x.numel() > 1000000:
+          x = x[torch.randint(x.numel(), (1000000,), device=x.device)]
+        value = torch.quantile(x, self.percentile / 100.).item()
+      else:
+        value = x.max().item()
+      self.ranges[name] = max(self.ranges.get(name, 0.), value)
+    return hook
+
+  def remove(self):
+    for hook in self._hooks:
+      hook.remove()
+
+def main():
+  # Parse the command line arguments
+  cfg = parse_args(description='Calibrates the activation ranges of a trained model for int8 inference and exports the weights (TZA).')
+
+  # Initialize the PyTorch device
+  device = init_device(cfg)
+
+  # Initialize the inference function
+  infer = Infer(cfg, device)
+  print('Result:', cfg.result)
+  print('Epoch:', infer.epoch)
+
+  # Initialize the dataset
+  data_dir = get_data_dir(cfg, cfg.input_data)
+  image_sample_groups = get_image_sample_groups(data_dir, infer.features)
+
+  # Observe the activations of the calibration images
+  observer = ActivationObserver(infer.model, cfg.percentile)
+
+  print()
+  with torch.inference_mode():
+    for _, input_names, _ in image_sample_groups:
+      for input_name in input_names:
+        print(input_name)
+
+        input, _ = load_image_features(os.path.join(data_dir, input_name), infer.features)
+        exposure = autoexposure(input) if infer.main_feature == 'hdr' else 1.
+        input = image_to_tensor(input, batch=True).to(device)
+        infer(input, exposure)
+
+  observer.remove()
+  if not observer.ranges:
+    error('no calibration images')
+
+  # Save the weights and the activation scales to a TZA file
+  # The output of the last convolution is not quantized
+  if cfg.output:
+    output_filename = cfg.output
+  else:
+    output_filename = os.path.join(get_result_dir(cfg), cfg.result)
+    if cfg.num_epochs:
+      output_filename += '_%d' % infer.epoch
+    output_filename += '_int8.tza'
+  print()
+  print('Output:', output_filename)
+  print()
+
+  with tza.Writer(output_filename) as output_file:
+    for name, value in infer.model.state_dict().items():
+      tensor = value.half().cpu().numpy()
+      if name.endswith('.weight') and len(value.shape) == 4:
+        layout = 'oihw'
+      elif len(value.shape) == 1:
+        layout = 'x'
+      else:
+        error('unknown state value')
+      output_file.write(name, tensor, layout)
+
+    for name in observer.conv_names[:-1]:
+      scale = max(observer.ranges[name], 1e-6) / 255.
+      print(name, 'range=%.4f' % observer.ranges[name])
+      output_file.write(name + '.dst_scale', np.array([scale], dtype=np.float32), 'x')
+
+if __name__ == '__main__':
+  main()
@@ -83,23 +83,23 @@ def parse_args(cmd=None, description=None):
     parser.add_argument('--valid_data', '-v', type=str,
                         help='name of the validation dataset')
 
-  if cmd in {'preprocess', 'infer'}:
+  if cmd in {'preprocess', 'infer', 'calibrate'}:
     parser.add_argument('--data_dir', '-D', type=str, default='data',
                         help='directory of datasets (e.g. training, validation, test)')
 
-  if cmd in {'preprocess', 'train', 'find_lr', 'infer', 'export', 'visualize'}:
+  if cmd in {'preprocess', 'train', 'find_lr', 'infer', 'export', 'calibrate', 'visualize'}:
     parser.add_argument('--results_dir', '-R', type=str, default='results',
                         help='directory of training results')
 
-  if cmd in {'train', 'find_lr', 'infer', 'export', 'visualize'}:
+  if cmd in {'train', 'find_lr', 'infer', 'export', 'calibrate', 'visualize'}:
     parser.add_argument('--result', '-r', type=str, required=(not cmd in {'train', 'find_lr'}),
                         help='name of the training result')
 
-  if cmd in {'preprocess', 'train', 'find_lr', 'infer'}:
+  if cmd in {'preprocess', 'train', 'find_lr', 'infer', 'calibrate'}:
     parser.add_argument('--aux_results', '-a', type=str, nargs='*', default=[],
                         help='prefilter auxiliary features using the specified training results')
 
-  if cmd in {'preprocess', 'train', 'infer', 'export'}:
+  if cmd in {'preprocess', 'train', 'infer', 'export', 'calibrate'}:
     parser.add_argument('--num_epochs', '--epochs', '-e', type=int,
                         default=(2000 if cmd == 'train' else None),
                         help='number of training epochs')
@@ -163,12 +163,23 @@ def parse_args(cmd=None, description=None):
     parser.add_argument('--save_all', action='store_true',
                         help='save input and target images too')
 
+  if cmd in {'calibrate'}:
+    parser.add_argument('--input_data', '-i', type=str, default='valid',
+                        help='name of the calibration dataset')
+    parser.add_argument('--percentile', type=float, default=100.,
+                        help='percentile of the activations used as their range (clipping outliers)')
+    parser.add_argument('--output', '-o', type=str,
+                        help='output file')
+
   if cmd in {'export'}:
     parser.add_argument('target', type=str, nargs='?',
                         choices=['weights', 'package', 'onnx', 'onnx_noparams'], default='weights',
                         help='what to export')
     parser.add_argument('--output', '-o', type=str,
                         help='output file')
+    parser.add_argument('--layouts', type=str, nargs='*', default=[],
+                        help='additional pre-reordered weight layouts with optional data type '
+                             '(e.g. OIhw16i16o or OIhw16i16o:f16, default data type is f32)')
 
   if cmd in {'convert_image', 'split_exr'}:
     parser.add_argument('input', type=str,
@@ -190,7 +201,7 @@ def parse_args(cmd=None, description=None):
     parser.add_argument('--layer', type=str,
                         help='name of the image layer')
 
-  if cmd in {'preprocess', 'train', 'find_lr', 'infer', 'export'}:
+  if cmd in {'preprocess', 'train', 'find_lr', 'infer', 'export', 'calibrate'}:
     parser.add_argument('--device', '-d', type=str,
                         choices=['cpu', 'cuda', 'mps'], default=get_default_device(),
                         help='type of device(s) to use')
@@ -199,7 +210,7 @@ def parse_args(cmd=None, description=None):
     parser.add_argument('--num_devices', '-n', type=int, default=1,
                         help='number of devices to use (with IDs device_id .. device_id+num_devices-1)')
     advanced.add_argument('--deterministic', '--det', action='store_true',
-                          default=(cmd in {'preprocess', 'infer', 'export'}),
+                          default=(cmd in {'preprocess', 'infer', 'export', 'calibrate'}),
                           help='makes computations deterministic (slower performance)')
 
   cfg = parser.parse_args()
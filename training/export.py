@@ -88,6 +88,17 @@ def main():
             error('unknown state value')
 
           output_file.write(name, tensor, layout)
+
+          # Write pre-reordered variants of the weights, which can be used by the devices
+          # without reordering
+          if layout == 'oihw':
+            for variant in cfg.layouts:
+              variant_layout, _, variant_dtype = variant.partition(':')
+              if variant_dtype not in {'', 'f32', 'f16'}:
+                error('unsupported weight data type')
+              variant_tensor = value.half() if variant_dtype == 'f16' else value.float()
+              variant_tensor = tza.reorder_weight(variant_tensor.cpu().numpy(), variant_layout)
+              output_file.write(name, variant_tensor, variant_layout, shape=tensor.shape)
     elif cfg.target in {'onnx', 'onnx_noparams'}:
       # Export the model to ONNX
       if cfg.output:
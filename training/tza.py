@@ -1,13 +1,54 @@
 ## Copyright 2018 Intel Corporation
 ## SPDX-License-Identifier: Apache-2.0
 
+import re
 import struct
 import numpy as np
 
 # Tensor Archive (TZA) file format
-VERSION = (2, 0)
+# Version 3 stores the layouts with their length, so blocked (pre-reordered) layouts can be stored too
+# Version 3.1 may store multiple variants of a tensor with the same name but different layouts and/or
+# data types (e.g. the original weights and pre-reordered weights for several devices)
+VERSION = (3, 1)
 _MAGIC = 0x41D7
 
+# Blocked weight layouts (e.g. OIhw16i16o), optionally with the order of the blocks swapped (IOhw)
+_BLOCKED_LAYOUT_RE = re.compile(r'^(OI|IO)hw(\d+)i(\d+)o$')
+
+# Returns whether a layout is a plain (non-blocked) layout with one character per dimension
+def is_plain_layout(layout):
+  return layout.islower()
+
+# Returns the shape of a tensor with padding to the block size of its layout
+def get_padded_shape(shape, layout):
+  if is_plain_layout(layout):
+    return tuple(shape)
+  B = int(_BLOCKED_LAYOUT_RE.match(layout).group(2))
+  O, I, H, W = shape
+  return ((O + B - 1) // B * B, (I + B - 1) // B * B, H, W)
+
+# Reorders an oihw weight tensor to a blocked layout (e.g. OIhw16i16o), padding the input and output
+# channels to the block size
+def reorder_weight(weight, layout):
+  match = _BLOCKED_LAYOUT_RE.match(layout)
+  if weight.ndim != 4 or not match:
+    raise ValueError('unsupported weight layout')
+  block_i, block_o = int(match.group(2)), int(match.group(3))
+  if block_i != block_o:
+    raise ValueError('unsupported weight layout')
+  B = block_i
+
+  O, I, H, W = weight.shape
+  O_pad, I_pad, _, _ = get_padded_shape(weight.shape, layout)
+  padded = np.zeros((O_pad, I_pad, H, W), dtype=weight.dtype)
+  padded[:O, :I, :, :] = weight
+
+  # o i h w -> O ob I ib h w -> O I h w ib ob
+  blocked = padded.reshape(O_pad // B, B, I_pad // B, B, H, W).transpose(0, 2, 4, 5, 3, 1)
+  if match.group(1) == 'IO':
+    blocked = blocked.transpose(1, 0, 2, 3, 4, 5)
+  return np.ascontiguousarray(blocked)
+
 # Writes tensors to a TZA file
 class Writer(object):
   # Creates a new file
@@ -67,12 +108,21 @@ class Writer(object):
   # Writes the header to the file
   def _write_header(self):
     self._write_uint16(_MAGIC)
-    self._write_uint8(VERSION[0])
-    self._write_uint8(VERSION[1])
+    self._write_uint8(0) # placeholder for the version
+    self._write_uint8(0)
     self._write_uint64(0) # placeholder for the table offset
 
   # Writes the table to the file
   def _write_table(self):
+    # Use the oldest version which can store all tensors for compatibility
+    names = [entry[0] for entry in self._table]
+    if len(set(names)) < len(names):
+      version = VERSION
+    elif not all(is_plain_layout(entry[2]) for entry in self._table):
+      version = (3, 0)
+    else:
+      version = (2, 0)
+
     self._write_pad()
     table_offset = self._file.tell()
     self._write_uint32(len(self._table))
@@ -83,20 +133,33 @@ class Writer(object):
       self._write_uint8(ndims)
       for dim in shape:
         self._write_uint32(dim)
+      if version[0] >= 3:
+        self._write_uint8(len(layout))
       self._write_raw_str(layout)
       self._write_raw_str(dtype)
       self._write_uint64(offset)
 
-    self._file.seek(4) # skip magic and version
+    self._file.seek(2) # skip magic
+    self._write_uint8(version[0])
+    self._write_uint8(version[1])
     self._write_uint64(table_offset)
 
   # Writes a tensor to the file
-  def write(self, name, tensor, layout):
-    shape = tensor.shape
+  # Blocked weights must be reordered with reorder_weight, but the shape of the original tensor
+  # must be specified
+  def write(self, name, tensor, layout, shape=None):
+    if shape is None:
+      shape = tensor.shape
     ndims = len(shape)
-    if len(layout) != ndims:
+    if is_plain_layout(layout):
+      if len(layout) != ndims or tuple(shape) != tensor.shape:
+        raise ValueError('invalid tensor layout')
+    elif ndims != 4 or not _BLOCKED_LAYOUT_RE.match(layout):
       raise ValueError('invalid tensor layout')
     dtype = self._encode_dtype(tensor.dtype)
+    for entry in self._table:
+      if entry[0] == name and entry[2] == layout and entry[3] == dtype:
+        raise ValueError('duplicate tensor variant')
     self._write_pad()
     offset = self._file.tell()
 
@@ -132,18 +195,26 @@ class Reader(object):
     return len(self._table)
 
   # Returns a (tensor, layout) tuple given the name of a tensor
+  # If the tensor has multiple variants, the plain (original) variant is returned
   def __getitem__(self, name):
+    return self._get_tensor(self._table[name])
+
+  # Returns a list of (tensor, layout) tuples for all variants of a tensor
+  def get_variants(self, name):
+    return [self._get_tensor(entry) for entry in self._variants[name]]
+
+  def _get_tensor(self, entry):
     # Lazily map the entire file into memory
     if self._buffer is None:
       self._buffer = np.memmap(self.filename,
                                dtype=np.uint8,
                                mode='r')
 
-    # Look up the requested tensor in the table
-    shape, layout, dtype, offset = self._table[name]
+    shape, layout, dtype, offset = entry
 
     # Get the tensor from the memory mapped buffer
-    tensor = np.ndarray(shape,
+    # Blocked tensors are returned with the padded shape (but in the blocked layout)
+    tensor = np.ndarray(get_padded_shape(shape, layout),
                         dtype=dtype,
                         buffer=self._buffer,
                         offset=offset)
@@ -192,13 +263,14 @@ class Reader(object):
     if magic != _MAGIC:
       raise ValueError('invalid tensor format')
     self._version = (self._read_uint8(), self._read_uint8())
-    if self._version[0] != VERSION[0]:
+    if self._version[0] not in (2, VERSION[0]):
       raise ValueError('unsupported tensor format version')
     self._table_offset = self._read_uint64()
 
   # Reads the table from the file
   def _read_table(self):
     self._table = {}
+    self._variants = {}
     self._file.seek(self._table_offset)
     num_tensors = self._read_uint32()
 
@@ -206,8 +278,11 @@ class Reader(object):
       name = self._read_str()
       ndims = self._read_uint8()
       shape = tuple(self._read_uint32() for _ in range(ndims))
-      layout = self._read_raw_str(ndims)
+      layout = self._read_raw_str(self._read_uint8() if self._version[0] >= 3 else ndims)
       dtype = self._decode_dtype(self._read_raw_str(1))
       offset = self._read_uint64()
 
-      self._table[name] = (shape, layout, dtype, offset)
+      entry = (shape, layout, dtype, offset)
+      self._variants.setdefault(name, []).append(entry)
+      if name not in self._table or is_plain_layout(layout):
+        self._table[name] = entry